@@ -11,6 +11,7 @@
 #include <bl1.h>
 #include <bl_common.h>
 #include <console.h>
+#include <crypto_mod.h>
 #include <debug.h>
 #include <errata_report.h>
 #include <platform.h>
@@ -209,6 +210,11 @@ static void bl1_load_bl2(void)
 		plat_error_handler(err);
 	}
 
+#if TRUSTED_BOARD_BOOT
+	/* BL2 is authenticated, release the crypto library state */
+	crypto_mod_flush_cache();
+#endif
+
 	/* Allow platform to handle image information. */
 	err = bl1_plat_handle_post_image_load(BL2_IMAGE_ID);
 	if (err) {
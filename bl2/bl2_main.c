@@ -10,6 +10,7 @@
 #include <bl2.h>
 #include <bl_common.h>
 #include <console.h>
+#include <crypto_mod.h>
 #include <debug.h>
 #include <platform.h>
 #include "bl2_private.h"
@@ -28,6 +29,9 @@
 void bl2_main(void)
 {
 	entry_point_info_t *next_bl_ep_info;
+#if TRUSTED_BOARD_BOOT
+	auth_mod_stats_t auth_stats;
+#endif
 
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
@@ -46,6 +50,15 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if TRUSTED_BOARD_BOOT
+	/* All images are authenticated, release the crypto library state */
+	crypto_mod_flush_cache();
+
+	auth_mod_get_stats(&auth_stats);
+	INFO("BL2: %u signatures verified, %u parent authentications skipped\n",
+	     auth_stats.sig_verified, auth_stats.parent_auth_skipped);
+#endif /* TRUSTED_BOARD_BOOT */
+
 #ifdef AARCH32
 	/*
 	 * For AArch32 state BL1 and BL2 share the MMU setup.
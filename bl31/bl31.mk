@@ -29,10 +29,31 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				${SPM_SOURCES}					\
 
 
+ifeq (${ENABLE_LOG_RING}, 1)
+BL31_SOURCES		+=	common/tf_log_ring.c
+endif
+
 ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_PMF_TRACE}, 1)
+BL31_SOURCES		+=	lib/pmf/pmf_trace.c
+endif
+
+ifeq (${ENABLE_SMC_STATS},1)
+BL31_SOURCES		+=	common/runtime_svc_stats.c
+endif
+
+ifeq (${ENABLE_LOCK_PROF},1)
+BL31_SOURCES		+=	lib/locks/lock_prof.c
+endif
+
+ifeq (${PREGENERATE_XLAT_TABLES},1)
+include tools/xlat_tables_gen/xlat_tables_gen.mk
+BL31_SOURCES		+=	${XLATGEN_OUT}
+endif
+
 ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
@@ -22,7 +22,7 @@
 
 #if ENABLE_RUNTIME_INSTRUMENTATION
 PMF_REGISTER_SERVICE_SMC(rt_instr_svc, PMF_RT_INSTR_SVC_ID,
-	RT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE)
+	RT_INSTR_TOTAL_IDS, PMF_STORE_ENABLE | PMF_TRACE_ENABLE)
 #endif
 
 /*******************************************************************************
@@ -120,6 +120,11 @@ void bl31_main(void)
 	 * from BL31
 	 */
 	bl31_plat_runtime_setup();
+
+#if ENABLE_LOG_RING
+	/* From now on, log messages are only output to the consoles on demand */
+	tf_log_ring_enable();
+#endif
 }
 
 /*******************************************************************************
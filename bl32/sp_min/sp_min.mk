@@ -22,6 +22,10 @@ ifeq (${ENABLE_PMF}, 1)
 BL32_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_PMF_TRACE}, 1)
+BL32_SOURCES		+=	lib/pmf/pmf_trace.c
+endif
+
 ifeq (${ENABLE_AMU}, 1)
 BL32_SOURCES		+=	lib/extensions/amu/aarch32/amu.c\
 				lib/extensions/amu/aarch32/amu_helpers.S
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -341,12 +341,21 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 {
 	uint64_t results[2];
 	uint64_t service_args[2];
+	uint64_t entry_count = read_cntpct_el0();
 	uint32_t linear_id = plat_my_core_pos();
 
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
 
+	/*
+	 * Return straight away from a NOP request, which is used to measure
+	 * the cost of the world switch alone, without logging or requesting
+	 * the arguments from the dispatcher.
+	 */
+	if (TSP_BARE_FID(func) == TSP_NOP)
+		return set_smc_args(func, 0, entry_count, 0, 0, 0, 0, 0);
+
 	INFO("TSP: cpu 0x%lx received %s smc 0x%lx\n", read_mpidr(),
 		((func >> 31) & 1) == 1 ? "fast" : "yielding",
 		func);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -199,15 +199,59 @@ size_t image_size(unsigned int image_id)
 
 #if LOAD_IMAGE_V2
 
+#if TRUSTED_BOARD_BOOT
+/*
+ * Size of the chunks in which an image authenticated by hash is read, so that
+ * each chunk is hashed while it is still in the data cache.
+ */
+#define LOAD_IMAGE_HASH_CHUNK_SIZE	U(0x10000)
+
+/*******************************************************************************
+ * Read an image in chunks, passing each of them to the authentication module
+ * as soon as it has been loaded.
+ ******************************************************************************/
+static int read_and_hash_image(unsigned int image_id, uintptr_t image_handle,
+			       uintptr_t image_base, size_t image_size,
+			       size_t *bytes_read)
+{
+	size_t offset, chunk_size, chunk_read;
+	int io_result;
+
+	for (offset = 0; offset < image_size; offset += chunk_read) {
+		chunk_size = image_size - offset;
+		if (chunk_size > LOAD_IMAGE_HASH_CHUNK_SIZE)
+			chunk_size = LOAD_IMAGE_HASH_CHUNK_SIZE;
+
+		io_result = io_read(image_handle, image_base + offset,
+				    chunk_size, &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0))
+			break;
+
+		if (auth_mod_hash_update(image_id, (void *)(image_base + offset),
+					 chunk_read) != 0) {
+			io_result = -EAUTH;
+			break;
+		}
+	}
+
+	*bytes_read = offset;
+
+	return io_result;
+}
+#endif /* TRUSTED_BOARD_BOOT */
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
- * If the load is successful then the image information is updated.
+ * If the load is successful then the image information is updated. If
+ * 'hash_image' is set, the image is passed to the authentication module in
+ * chunks as it is read (see auth_mod_hash_start()).
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      int hash_image)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
@@ -260,7 +304,17 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
+#if TRUSTED_BOARD_BOOT
+	if (hash_image != 0)
+		io_result = read_and_hash_image(image_id, image_handle,
+						image_base, image_size,
+						&bytes_read);
+	else
+		io_result = io_read(image_handle, image_base, image_size,
+				    &bytes_read);
+#else
 	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+#endif
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -285,6 +339,7 @@ static int load_auth_image_internal(unsigned int image_id,
 				    int is_parent_image)
 {
 	int rc;
+	int hash_image = 0;
 
 #if TRUSTED_BOARD_BOOT
 	unsigned int parent_id;
@@ -297,10 +352,13 @@ static int load_auth_image_internal(unsigned int image_id,
 			return rc;
 		}
 	}
+
+	/* Hash the image while loading it, if it is authenticated by hash */
+	hash_image = (auth_mod_hash_start(image_id) == 0);
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
-	rc = load_image(image_id, image_data);
+	rc = load_image(image_id, image_data, hash_image);
 	if (rc != 0) {
 		return rc;
 	}
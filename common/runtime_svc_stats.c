@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cassert.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <utils_def.h>
+
+/*
+ * Number of runtime service descriptors, and of distinct SMC function IDs per
+ * CPU, for which statistics are kept. Calls beyond these limits are only
+ * accounted for in the dropped count.
+ */
+#ifndef PLAT_RT_SVC_STATS_MAX_SVCS
+#define PLAT_RT_SVC_STATS_MAX_SVCS	16
+#endif
+
+#ifndef PLAT_RT_SVC_STATS_MAX_FIDS
+#define PLAT_RT_SVC_STATS_MAX_FIDS	16
+#endif
+
+CASSERT(IS_POWER_OF_TWO(PLAT_RT_SVC_STATS_MAX_FIDS),
+	assert_rt_svc_stats_max_fids_power_of_two);
+
+#define RT_SVC_DESCS_START	((uintptr_t) (&__RT_SVC_DESCS_START__))
+
+typedef struct rt_svc_stats_entry {
+	unsigned long long count;
+	unsigned long long ticks;
+	unsigned int hist[RT_SVC_STATS_HIST_BUCKETS];
+} rt_svc_stats_entry_t;
+
+typedef struct rt_svc_stats_fid_entry {
+	uint32_t fid;
+	rt_svc_stats_entry_t stats;
+} rt_svc_stats_fid_entry_t;
+
+/*
+ * Statistics of a CPU. Only the owning CPU updates them, so they are kept in
+ * their own cache lines and updated without locking.
+ */
+typedef struct rt_svc_stats_cpu {
+	rt_svc_stats_entry_t svc[PLAT_RT_SVC_STATS_MAX_SVCS];
+	rt_svc_stats_fid_entry_t fid[PLAT_RT_SVC_STATS_MAX_FIDS];
+	unsigned long long dropped;
+} __aligned(CACHE_WRITEBACK_GRANULE) rt_svc_stats_cpu_t;
+
+static rt_svc_stats_cpu_t rt_svc_stats[PLATFORM_CORE_COUNT];
+
+/*
+ * Index of the first slot to probe for a function ID in the per-CPU table.
+ * The multiplication spreads the function numbers of an owning entity, which
+ * are usually contiguous, across the table.
+ */
+static unsigned int rt_svc_stats_fid_slot(uint32_t smc_fid)
+{
+	return ((smc_fid * 0x9e3779b1U) >> 16) &
+		(PLAT_RT_SVC_STATS_MAX_FIDS - 1);
+}
+
+/*
+ * Find the entry of a function ID in the per-CPU table. Entries are claimed in
+ * probe order and never released, so the first free slot terminates the
+ * search. The free slot is claimed if 'alloc' is set.
+ */
+static rt_svc_stats_fid_entry_t *rt_svc_stats_find_fid(
+		rt_svc_stats_cpu_t *stats, uint32_t smc_fid, int alloc)
+{
+	rt_svc_stats_fid_entry_t *entry;
+	unsigned int i, slot = rt_svc_stats_fid_slot(smc_fid);
+
+	for (i = 0; i < PLAT_RT_SVC_STATS_MAX_FIDS; i++) {
+		entry = &stats->fid[slot];
+
+		if (entry->stats.count == 0) {
+			if (!alloc)
+				return NULL;
+			entry->fid = smc_fid;
+			return entry;
+		}
+
+		if (entry->fid == smc_fid)
+			return entry;
+
+		slot = (slot + 1) & (PLAT_RT_SVC_STATS_MAX_FIDS - 1);
+	}
+
+	return NULL;
+}
+
+static void rt_svc_stats_update(rt_svc_stats_entry_t *entry,
+				unsigned long long ticks, unsigned int bucket)
+{
+	entry->count++;
+	entry->ticks += ticks;
+	entry->hist[bucket]++;
+}
+
+static void rt_svc_stats_record(uint32_t smc_fid, unsigned int svc_idx,
+				unsigned long long ticks)
+{
+	rt_svc_stats_cpu_t *stats = &rt_svc_stats[plat_my_core_pos()];
+	rt_svc_stats_fid_entry_t *entry;
+	unsigned int bucket;
+
+	bucket = (ticks == 0) ? 0 : (64 - __builtin_clzll(ticks));
+	if (bucket >= RT_SVC_STATS_HIST_BUCKETS)
+		bucket = RT_SVC_STATS_HIST_BUCKETS - 1;
+
+	if (svc_idx < PLAT_RT_SVC_STATS_MAX_SVCS)
+		rt_svc_stats_update(&stats->svc[svc_idx], ticks, bucket);
+	else
+		stats->dropped++;
+
+	entry = rt_svc_stats_find_fid(stats, smc_fid, 1);
+	if (entry != NULL)
+		rt_svc_stats_update(&entry->stats, ticks, bucket);
+	else
+		stats->dropped++;
+}
+
+/*******************************************************************************
+ * SMC handler called from the EL3 exception vectors in place of the handler of
+ * the runtime service when ENABLE_SMC_STATS is set. The vectors have already
+ * validated the descriptor index. The measured latency includes the time spent
+ * in lower ELs by services that enter them synchronously. Calls that do not
+ * return, e.g. to power down the CPU, are not recorded.
+ ******************************************************************************/
+uintptr_t rt_svc_stats_handle_smc(uint32_t smc_fid,
+				  u_register_t x1,
+				  u_register_t x2,
+				  u_register_t x3,
+				  u_register_t x4,
+				  void *cookie,
+				  void *handle,
+				  u_register_t flags)
+{
+	const rt_svc_desc_t *rt_svc_descs;
+	unsigned long long start;
+	unsigned int idx;
+	uintptr_t rc;
+
+	idx = rt_svc_descs_indices[get_unique_oen_from_smc_fid(smc_fid)];
+	rt_svc_descs = (const rt_svc_desc_t *) RT_SVC_DESCS_START;
+
+	start = read_cntpct_el0();
+	rc = rt_svc_descs[idx].handle(smc_fid, x1, x2, x3, x4, cookie,
+				      handle, flags);
+	rt_svc_stats_record(smc_fid, idx, read_cntpct_el0() - start);
+
+	return rc;
+}
+
+/*******************************************************************************
+ * Retrieve the statistic selected by 'query' for the CPU 'cpu_idx'. For the
+ * RT_SVC_STATS_FID query, 'smc_fid' is the index of a slot in the function ID
+ * table of the CPU and the function ID recorded in it is returned, which allows
+ * the caller to enumerate the function IDs seen by the CPU. Function IDs that
+ * have not been seen read as 0.
+ ******************************************************************************/
+int rt_svc_stats_get(unsigned int cpu_idx, uint32_t smc_fid,
+		     unsigned int query, unsigned long long *value)
+{
+	rt_svc_stats_cpu_t *stats;
+	const rt_svc_stats_fid_entry_t *fid_entry;
+	const rt_svc_stats_entry_t *entry;
+	unsigned int oen, svc_idx, field = query & ~RT_SVC_STATS_PER_SVC;
+
+	assert(value != NULL);
+
+	/* The value is returned to the caller even when the query fails */
+	*value = 0;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT)
+		return -EINVAL;
+
+	stats = &rt_svc_stats[cpu_idx];
+
+	if (query == RT_SVC_STATS_DROPPED) {
+		*value = stats->dropped;
+		return 0;
+	}
+
+	if (query == RT_SVC_STATS_FID) {
+		if ((smc_fid >= PLAT_RT_SVC_STATS_MAX_FIDS) ||
+		    (stats->fid[smc_fid].stats.count == 0))
+			return -EINVAL;
+
+		*value = stats->fid[smc_fid].fid;
+		return 0;
+	}
+
+	if (query & RT_SVC_STATS_PER_SVC) {
+		oen = get_unique_oen_from_smc_fid(smc_fid);
+		svc_idx = rt_svc_descs_indices[oen];
+		if (svc_idx >= PLAT_RT_SVC_STATS_MAX_SVCS)
+			return -EINVAL;
+
+		entry = &stats->svc[svc_idx];
+	} else {
+		fid_entry = rt_svc_stats_find_fid(stats, smc_fid, 0);
+		if (fid_entry == NULL)
+			return 0;
+
+		entry = &fid_entry->stats;
+	}
+
+	if (field == RT_SVC_STATS_COUNT) {
+		*value = entry->count;
+	} else if (field == RT_SVC_STATS_TICKS) {
+		*value = entry->ticks;
+	} else if ((field >= RT_SVC_STATS_HIST(0)) &&
+		   (field < RT_SVC_STATS_HIST(RT_SVC_STATS_HIST_BUCKETS))) {
+		*value = entry->hist[field - RT_SVC_STATS_HIST(0)];
+	} else {
+		return -EINVAL;
+	}
+
+	return 0;
+}
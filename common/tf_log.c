@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,6 +23,9 @@ void tf_log(const char *fmt, ...)
 	unsigned int log_level;
 	va_list args;
 	const char *prefix_str;
+#if ENABLE_LOG_RING && defined(IMAGE_BL31)
+	int rc;
+#endif
 
 	/* We expect the LOG_MARKER_* macro as the first character */
 	log_level = fmt[0];
@@ -36,6 +39,16 @@ void tf_log(const char *fmt, ...)
 
 	prefix_str = plat_log_get_prefix(log_level);
 
+#if ENABLE_LOG_RING && defined(IMAGE_BL31)
+	/* Defer the output to the consoles if the log ring is enabled */
+	va_start(args, fmt);
+	rc = tf_log_ring_vlog(log_level, prefix_str, fmt+1, args);
+	va_end(args);
+
+	if (rc == 0)
+		return;
+#endif
+
 	if (prefix_str != NULL)
 		tf_string_print(prefix_str);
 
@@ -59,3 +72,62 @@ void tf_log_set_max_level(unsigned int log_level)
 		max_log_level = log_level;
 
 }
+
+#if ENABLE_BINARY_LOG
+/* Identifier of the image, output in the binary log records */
+#if defined(IMAGE_BL1)
+#define TF_BLOG_IMAGE_ID	1
+#elif defined(IMAGE_BL2)
+#define TF_BLOG_IMAGE_ID	2
+#elif defined(IMAGE_BL2U)
+#define TF_BLOG_IMAGE_ID	3
+#elif defined(IMAGE_BL31)
+#define TF_BLOG_IMAGE_ID	4
+#elif defined(IMAGE_BL32)
+#define TF_BLOG_IMAGE_ID	5
+#else
+#define TF_BLOG_IMAGE_ID	0
+#endif
+
+/*
+ * The identifier is also stored at the start of the format string section, so
+ * that the decoder can match the records with the ELF file of their image.
+ */
+static const unsigned char tf_blog_image_id
+	__section(TF_BLOG_FMT_SECTION ".image_id") __used = TF_BLOG_IMAGE_ID;
+
+/*
+ * The functions below output the binary log records described in debug.h.
+ * They should not be directly invoked and are meant to be only used by the
+ * log macros. tf_blog_start() returns 0 if the message must be discarded, in
+ * which case its arguments must not be output.
+ */
+int tf_blog_start(unsigned int log_level, uintptr_t fmt_id, unsigned int nargs)
+{
+	unsigned int i;
+
+	assert(log_level && log_level <= LOG_LEVEL_VERBOSE);
+	assert(log_level % 10 == 0);
+
+	if (log_level > max_log_level)
+		return 0;
+
+	putchar(TF_BLOG_MARKER);
+	putchar(TF_BLOG_IMAGE_ID);
+	putchar(log_level);
+	for (i = 0; i < 4; i++)
+		putchar((fmt_id >> (i * 8)) & 0xff);
+	putchar(nargs);
+
+	return 1;
+}
+
+void tf_blog_arg(const void *arg, unsigned int size)
+{
+	const unsigned char *byte = arg;
+
+	putchar(size);
+	while (size--)
+		putchar(*byte++);
+}
+#endif
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <console.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <string.h>
+#include <utils_def.h>
+
+/*
+ * Size in bytes of the log ring of each CPU. When a ring is full, the oldest
+ * characters that have not been drained yet are overwritten.
+ */
+#ifndef PLAT_LOG_RING_SIZE
+#define PLAT_LOG_RING_SIZE		1024
+#endif
+
+CASSERT(IS_POWER_OF_TWO(PLAT_LOG_RING_SIZE), assert_log_ring_size_power_of_two);
+
+#define LOG_RING_IDX_MASK		(PLAT_LOG_RING_SIZE - 1)
+
+/* Number of characters copied out of a ring at a time while draining it */
+#define LOG_RING_DRAIN_CHUNK		64
+
+/*
+ * Log ring of a CPU. Only the owning CPU writes into it, without locking.
+ * 'head' counts the characters of the complete messages written since the
+ * ring was enabled, and character 'n' is stored in 'buf[n % size]'. 'wr' is
+ * the write cursor of the owner, which runs ahead of 'head' while a message is
+ * being formatted. It is advanced before each character is stored, so a reader
+ * that finds 'wr - n > size' after copying character 'n' knows that it may
+ * have been overwritten.
+ */
+typedef struct log_ring {
+	unsigned long long head;
+	unsigned long long wr;
+	char buf[PLAT_LOG_RING_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) log_ring_t;
+
+/*
+ * Drain state of a log ring, updated by the CPU draining it. 'tail' is the
+ * value of 'head' up to which the ring has been output to the consoles.
+ */
+typedef struct log_ring_rd_state {
+	unsigned long long tail;
+	unsigned long long lost;
+} __aligned(CACHE_WRITEBACK_GRANULE) log_ring_rd_state_t;
+
+/*
+ * The platform may place the rings in memory that the normal world can read
+ * directly, at PLAT_LOG_RING_BASE. It must then map PLATFORM_CORE_COUNT
+ * log_ring_t structures there in BL31.
+ */
+#ifdef PLAT_LOG_RING_BASE
+#define log_rings	((log_ring_t *)PLAT_LOG_RING_BASE)
+#else
+static log_ring_t log_rings[PLATFORM_CORE_COUNT];
+#endif
+
+static log_ring_rd_state_t log_ring_rd_states[PLATFORM_CORE_COUNT];
+
+/* Serialises the CPUs draining the rings to the consoles */
+static spinlock_t log_ring_lock;
+LOCK_PROF_REGISTER(log_ring_lock, &log_ring_lock);
+
+static unsigned int log_ring_enabled;
+
+static int log_ring_pending(void);
+static void log_ring_drain_all(void);
+
+static int log_ring_putc(int c)
+{
+	log_ring_t *ring = &log_rings[plat_my_core_pos()];
+	unsigned long long wr = ring->wr;
+
+	/* Reserve the slot before overwriting it, see log_ring_t */
+	ring->wr = wr + 1;
+	dmbishst();
+	ring->buf[wr & LOG_RING_IDX_MASK] = (char)c;
+
+	return c;
+}
+
+/*******************************************************************************
+ * This function redirects the messages logged with tf_log() to the ring of the
+ * logging CPU from now on, except for errors. It is called by BL31 once it is
+ * about to leave the cold boot path.
+ ******************************************************************************/
+void tf_log_ring_enable(void)
+{
+#ifdef PLAT_LOG_RING_BASE
+	memset(log_rings, 0, PLATFORM_CORE_COUNT * sizeof(log_ring_t));
+	flush_dcache_range((uintptr_t)log_rings,
+			   PLATFORM_CORE_COUNT * sizeof(log_ring_t));
+#endif
+	log_ring_enabled = 1;
+}
+
+/*******************************************************************************
+ * This function writes a formatted message to the ring of the calling CPU. It
+ * returns 0 if the message was consumed, or -1 if the caller must print it
+ * synchronously instead. Errors are printed synchronously, once the messages
+ * that precede them have been drained.
+ ******************************************************************************/
+int tf_log_ring_vlog(unsigned int log_level, const char *prefix_str,
+		     const char *fmt, va_list args)
+{
+	log_ring_t *ring;
+
+	if (log_ring_enabled == 0)
+		return -1;
+
+	/*
+	 * Wait for the preceding messages to be output before an error, even
+	 * if another CPU is draining the rings.
+	 */
+	if (log_level <= LOG_LEVEL_ERROR) {
+		if (log_ring_pending() != 0) {
+			spin_lock(&log_ring_lock);
+			log_ring_drain_all();
+			spin_unlock(&log_ring_lock);
+		}
+		return -1;
+	}
+
+	if (prefix_str != NULL) {
+		while (*prefix_str != '\0')
+			log_ring_putc(*prefix_str++);
+	}
+	tf_vprintf_to(log_ring_putc, fmt, args);
+
+	/* Publish the message once it is complete */
+	ring = &log_rings[plat_my_core_pos()];
+	dmbishst();
+	ring->head = ring->wr;
+
+	return 0;
+}
+
+/*
+ * Output the characters of a ring that have not been drained yet. The owner of
+ * the ring may overwrite them while they are being copied, including while it
+ * formats a message that is not published yet, in which case they are
+ * discarded.
+ */
+static void log_ring_drain(log_ring_t *ring, log_ring_rd_state_t *rd_state)
+{
+	char chunk[LOG_RING_DRAIN_CHUNK];
+	unsigned long long head, wr, tail = rd_state->tail;
+	unsigned int i, num, skip;
+
+	while (1) {
+		head = ring->head;
+		dmbish();
+
+		if ((head - tail) > PLAT_LOG_RING_SIZE) {
+			rd_state->lost += head - tail - PLAT_LOG_RING_SIZE;
+			tail = head - PLAT_LOG_RING_SIZE;
+		}
+
+		if (head == tail)
+			break;
+
+		num = MIN(head - tail, (unsigned long long)sizeof(chunk));
+		for (i = 0; i < num; i++)
+			chunk[i] = ring->buf[(tail + i) & LOG_RING_IDX_MASK];
+
+		dmbish();
+		wr = ring->wr;
+		skip = 0;
+		if ((wr - tail) > PLAT_LOG_RING_SIZE)
+			skip = MIN(wr - tail - PLAT_LOG_RING_SIZE,
+				   (unsigned long long)num);
+
+		rd_state->lost += skip;
+		for (i = skip; i < num; i++)
+			(void)console_putc(chunk[i]);
+
+		tail += num;
+	}
+
+	rd_state->tail = tail;
+
+	if (rd_state->lost != 0) {
+		tf_printf("[%llu log characters lost]\n", rd_state->lost);
+		rd_state->lost = 0;
+	}
+}
+
+/*
+ * Returns 1 if a ring holds messages that have not been drained yet. This is
+ * checked without the lock: a stale drain state only makes the caller take the
+ * lock for nothing, and a message that another CPU is publishing at the same
+ * time is output by a later flush.
+ */
+static int log_ring_pending(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (log_rings[i].head != log_ring_rd_states[i].tail)
+			return 1;
+	}
+
+	return 0;
+}
+
+/* Output the pending messages of all the CPUs, with log_ring_lock held */
+static void log_ring_drain_all(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		log_ring_drain(&log_rings[i], &log_ring_rd_states[i]);
+
+	(void)console_flush();
+}
+
+/*******************************************************************************
+ * This function outputs the pending messages of all the CPUs to the consoles.
+ * It must only be called at points where the time spent polling the consoles
+ * does not matter, e.g. before a CPU idles or on request of the normal world.
+ * It returns without taking any lock when there is nothing to output, and
+ * without waiting when another CPU is already draining the rings. Messages
+ * published after that CPU went past their ring are output by a later flush.
+ ******************************************************************************/
+void tf_log_ring_flush(void)
+{
+	if ((log_ring_enabled == 0) || (log_ring_pending() == 0))
+		return;
+
+	if (spin_trylock(&log_ring_lock) == 0)
+		return;
+
+	log_ring_drain_all();
+
+	spin_unlock(&log_ring_lock);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,16 +23,21 @@
 	(((lcount) > 1) ? va_arg(args, unsigned long long int) :	\
 	((lcount) ? va_arg(args, unsigned long int) : va_arg(args, unsigned int)))
 
-void tf_string_print(const char *str)
+static void string_print(tf_putc_t putc_fn, const char *str)
 {
 	assert(str);
 
 	while (*str)
-		putchar(*str++);
+		putc_fn(*str++);
+}
+
+void tf_string_print(const char *str)
+{
+	string_print(putchar, str);
 }
 
-static void unsigned_num_print(unsigned long long int unum, unsigned int radix,
-			       char padc, int padn)
+static void unsigned_num_print(tf_putc_t putc_fn, unsigned long long int unum,
+			       unsigned int radix, char padc, int padn)
 {
 	/* Just need enough space to store 64 bit decimal integer */
 	unsigned char num_buf[20];
@@ -48,12 +53,12 @@ static void unsigned_num_print(unsigned long long int unum, unsigned int radix,
 
 	if (padn > 0) {
 		while (i < padn--) {
-			putchar(padc);
+			putc_fn(padc);
 		}
 	}
 
 	while (--i >= 0)
-		putchar(num_buf[i]);
+		putc_fn(num_buf[i]);
 }
 
 /*******************************************************************
@@ -75,8 +80,10 @@ static void unsigned_num_print(unsigned long long int unum, unsigned int radix,
  *
  * The print exits on all other formats specifiers other than valid
  * combinations of the above specifiers.
+ *
+ * The characters are output through `putc_fn`.
  *******************************************************************/
-void tf_vprintf(const char *fmt, va_list args)
+void tf_vprintf_to(tf_putc_t putc_fn, const char *fmt, va_list args)
 {
 	int l_count;
 	long long int num;
@@ -98,30 +105,33 @@ loop:
 			case 'd':
 				num = get_num_va_args(args, l_count);
 				if (num < 0) {
-					putchar('-');
+					putc_fn('-');
 					unum = (unsigned long long int)-num;
 					padn--;
 				} else
 					unum = (unsigned long long int)num;
 
-				unsigned_num_print(unum, 10, padc, padn);
+				unsigned_num_print(putc_fn, unum, 10, padc,
+						   padn);
 				break;
 			case 's':
 				str = va_arg(args, char *);
-				tf_string_print(str);
+				string_print(putc_fn, str);
 				break;
 			case 'p':
 				unum = (uintptr_t)va_arg(args, void *);
 				if (unum) {
-					tf_string_print("0x");
+					string_print(putc_fn, "0x");
 					padn -= 2;
 				}
 
-				unsigned_num_print(unum, 16, padc, padn);
+				unsigned_num_print(putc_fn, unum, 16, padc,
+						   padn);
 				break;
 			case 'x':
 				unum = get_unum_va_args(args, l_count);
-				unsigned_num_print(unum, 16, padc, padn);
+				unsigned_num_print(putc_fn, unum, 16, padc,
+						   padn);
 				break;
 			case 'z':
 				if (sizeof(size_t) == 8)
@@ -135,7 +145,8 @@ loop:
 				goto loop;
 			case 'u':
 				unum = get_unum_va_args(args, l_count);
-				unsigned_num_print(unum, 10, padc, padn);
+				unsigned_num_print(putc_fn, unum, 10, padc,
+						   padn);
 				break;
 			case '0':
 				padc = '0';
@@ -157,10 +168,15 @@ loop:
 			fmt++;
 			continue;
 		}
-		putchar(*fmt++);
+		putc_fn(*fmt++);
 	}
 }
 
+void tf_vprintf(const char *fmt, va_list args)
+{
+	tf_vprintf_to(putchar, fmt, args);
+}
+
 void tf_printf(const char *fmt, ...)
 {
 	va_list va;
@@ -23,6 +23,7 @@ static const gicv2_driver_data_t *driver_data;
  * when the system is fully coherent.
  */
 static spinlock_t gic_lock;
+LOCK_PROF_REGISTER(gic_lock, &gic_lock);
 
 /*******************************************************************************
  * Enable secure interrupts and use FIQs to route them. Disable legacy bypass
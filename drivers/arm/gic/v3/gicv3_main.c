@@ -22,6 +22,7 @@ static unsigned int gicv2_compat;
  * when the system is fully coherent.
  */
 static spinlock_t gic_lock;
+LOCK_PROF_REGISTER(gic_lock, &gic_lock);
 
 /*
  * Redistributor power operations are weakly bound so that they can be
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -32,6 +32,14 @@
 extern const auth_img_desc_t *const cot_desc_ptr;
 extern unsigned int auth_img_flags[];
 
+/* Image whose hash is being computed while it is loaded, if any */
+#define HASH_STREAM_NONE	(~0U)
+static unsigned int hash_stream_img_id = HASH_STREAM_NONE;
+static unsigned int hash_stream_len;
+
+/* Authentication statistics since boot */
+static auth_mod_stats_t auth_stats;
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -114,6 +122,23 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return rc;
 }
 
+/*
+ * Complete the hash authentication of an image whose data has been fed to the
+ * crypto module with auth_mod_hash_update() while it was being loaded.
+ */
+static int auth_hash_stream(unsigned int img_len)
+{
+	hash_stream_img_id = HASH_STREAM_NONE;
+
+	/* The whole image must have been hashed */
+	if (hash_stream_len != img_len) {
+		(void)crypto_mod_hash_verify();
+		return 1;
+	}
+
+	return crypto_mod_hash_verify();
+}
+
 /*
  * Authenticate by digital signature
  *
@@ -188,6 +213,7 @@ static int auth_signature(const auth_method_param_sig_t *param,
 		return_if_error(rc);
 
 		/* Ask the crypto module to verify the signature */
+		auth_stats.sig_verified++;
 		rc = crypto_mod_verify_signature(data_ptr, data_len,
 						 sig_ptr, sig_len,
 						 sig_alg_ptr, sig_alg_len,
@@ -204,6 +230,7 @@ static int auth_signature(const auth_method_param_sig_t *param,
 		}
 	} else {
 		/* Ask the crypto module to verify the signature */
+		auth_stats.sig_verified++;
 		rc = crypto_mod_verify_signature(data_ptr, data_len,
 						 sig_ptr, sig_len,
 						 sig_alg_ptr, sig_alg_len,
@@ -310,8 +337,13 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 		return 1;
 	}
 
-	/* Check if the parent has already been authenticated */
+	/*
+	 * Check if the parent has already been authenticated. Its parameters
+	 * needed to authenticate the children have been saved at that time, so
+	 * it does not need to be loaded and verified again.
+	 */
 	if (auth_img_flags[img_desc->parent->img_id] & IMG_FLAG_AUTHENTICATED) {
+		auth_stats.parent_auth_skipped++;
 		*parent_id = 0;
 		return 1;
 	}
@@ -320,6 +352,102 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Prepare to authenticate an image by hash while it is being loaded
+ *
+ * This is only possible for raw images authenticated by hash alone, whose
+ * parent has already been authenticated, and if the crypto library supports
+ * hashing in chunks. The caller must then pass every chunk of the image to
+ * auth_mod_hash_update() as soon as it has been loaded, and finally call
+ * auth_mod_verify_img() as usual.
+ *
+ * Return: 0 = hash started, Otherwise = the image must be hashed as a whole
+ * by auth_mod_verify_img()
+ */
+int auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_desc_t *auth_method = NULL;
+	const auth_method_param_hash_t *param = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	hash_stream_img_id = HASH_STREAM_NONE;
+
+	img_desc = &cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_NONE) {
+			continue;
+		}
+		if ((auth_method->type != AUTH_METHOD_HASH) ||
+		    (param != NULL)) {
+			return 1;
+		}
+		param = &auth_method->param.hash;
+	}
+
+	if ((param == NULL) || ((auth_img_flags[img_desc->parent->img_id] &
+				 IMG_FLAG_AUTHENTICATED) == 0)) {
+		return 1;
+	}
+
+	/* Get the hash from the parent image */
+	rc = auth_get_param(param->hash, img_desc->parent,
+			&hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_hash_start(hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	hash_stream_img_id = img_id;
+	hash_stream_len = 0;
+
+	return 0;
+}
+
+/*
+ * Feed the next loaded chunk of an image to the hash started by
+ * auth_mod_hash_start()
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_hash_update(unsigned int img_id, void *data_ptr,
+			 unsigned int data_len)
+{
+	int rc;
+
+	if (hash_stream_img_id != img_id) {
+		return 1;
+	}
+
+	rc = crypto_mod_hash_update(data_ptr, data_len);
+	if (rc != 0) {
+		hash_stream_img_id = HASH_STREAM_NONE;
+		return rc;
+	}
+
+	hash_stream_len += data_len;
+
+	return 0;
+}
+
+/*
+ * Return the number of digital signatures verified and the number of parent
+ * authentications skipped because the parent was already authenticated
+ */
+void auth_mod_get_stats(auth_mod_stats_t *stats)
+{
+	assert(stats != NULL);
+
+	*stats = auth_stats;
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -366,8 +494,12 @@ int auth_mod_verify_img(unsigned int img_id,
 			rc = 0;
 			break;
 		case AUTH_METHOD_HASH:
-			rc = auth_hash(&auth_method->param.hash,
-					img_desc, img_ptr, img_len);
+			if (hash_stream_img_id == img_id) {
+				rc = auth_hash_stream(img_len);
+			} else {
+				rc = auth_hash(&auth_method->param.hash,
+						img_desc, img_ptr, img_len);
+			}
 			break;
 		case AUTH_METHOD_SIG:
 			rc = auth_signature(&auth_method->param.sig,
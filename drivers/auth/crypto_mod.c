@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -103,3 +103,64 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start verifying a hash over data that will be supplied in chunks through
+ * crypto_mod_hash_update(). Returns CRYPTO_ERR_INIT if the library does not
+ * support it, in which case the caller should use crypto_mod_verify_hash().
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if ((crypto_lib_desc.hash_start == NULL) ||
+	    (crypto_lib_desc.hash_update == NULL) ||
+	    (crypto_lib_desc.hash_verify == NULL)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	return crypto_lib_desc.hash_start(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add a chunk of data to the hash started by crypto_mod_hash_start()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: next chunk of data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(crypto_lib_desc.hash_update != NULL);
+
+	return crypto_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Finish the hash started by crypto_mod_hash_start() and compare it with the
+ * expected value
+ */
+int crypto_mod_hash_verify(void)
+{
+	assert(crypto_lib_desc.hash_verify != NULL);
+
+	return crypto_lib_desc.hash_verify();
+}
+
+/*
+ * Release any state cached by the library between verifications. This should
+ * be called once a boot stage has finished authenticating images.
+ */
+void crypto_mod_flush_cache(void)
+{
+	if (crypto_lib_desc.flush_cache != NULL) {
+		crypto_lib_desc.flush_cache();
+	}
+}
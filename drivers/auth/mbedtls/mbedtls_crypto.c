@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,28 @@
 
 #define LIB_NAME		"mbed TLS"
 
+/*
+ * Number of parsed public keys kept between signature verifications. The
+ * same key (e.g. the ROTPK or the trusted world key) usually verifies several
+ * certificates in a row, so this avoids parsing it and setting up its bignums
+ * again for each certificate.
+ */
+#ifndef TF_MBEDTLS_PK_CACHE_SIZE
+#define TF_MBEDTLS_PK_CACHE_SIZE	2
+#endif
+
+#define PK_HASH_SIZE		32	/* SHA-256 */
+
+typedef struct pk_cache_entry {
+	unsigned char key_hash[PK_HASH_SIZE];
+	unsigned int key_len;
+	int valid;
+	mbedtls_pk_context pk;
+} pk_cache_entry_t;
+
+static pk_cache_entry_t pk_cache[TF_MBEDTLS_PK_CACHE_SIZE];
+static unsigned int pk_cache_next;
+
 /*
  * AlgorithmIdentifier  ::=  SEQUENCE  {
  *     algorithm               OBJECT IDENTIFIER,
@@ -45,6 +67,88 @@ static void init(void)
 	mbedtls_init();
 }
 
+/*
+ * Drop all the parsed public keys and release their memory
+ */
+static void flush_cache(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < TF_MBEDTLS_PK_CACHE_SIZE; i++) {
+		if (pk_cache[i].valid != 0) {
+			mbedtls_pk_free(&pk_cache[i].pk);
+		}
+		memset(&pk_cache[i], 0, sizeof(pk_cache[i]));
+	}
+	pk_cache_next = 0;
+}
+
+/*
+ * Return the parsed form of a DER encoded SubjectPublicKeyInfo, parsing it
+ * only if it is not already in the cache. Keys are identified by the SHA-256
+ * hash of their DER encoding.
+ */
+static int get_pk(void *pk_ptr, unsigned int pk_len, mbedtls_pk_context **pk)
+{
+	unsigned char key_hash[PK_HASH_SIZE];
+	pk_cache_entry_t *entry;
+	unsigned char *p, *end;
+	unsigned int i;
+	int rc;
+
+	rc = mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+			(unsigned char *)pk_ptr, pk_len, key_hash);
+	if (rc != 0) {
+		return rc;
+	}
+
+	for (i = 0; i < TF_MBEDTLS_PK_CACHE_SIZE; i++) {
+		entry = &pk_cache[i];
+		if ((entry->valid != 0) && (entry->key_len == pk_len) &&
+		    (memcmp(entry->key_hash, key_hash, PK_HASH_SIZE) == 0)) {
+			*pk = &entry->pk;
+			return 0;
+		}
+	}
+
+	/* Replace the oldest entry */
+	entry = &pk_cache[pk_cache_next];
+	pk_cache_next = (pk_cache_next + 1) % TF_MBEDTLS_PK_CACHE_SIZE;
+	if (entry->valid != 0) {
+		mbedtls_pk_free(&entry->pk);
+		entry->valid = 0;
+	}
+
+	mbedtls_pk_init(&entry->pk);
+	p = (unsigned char *)pk_ptr;
+	end = (unsigned char *)(p + pk_len);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, &entry->pk);
+	if (rc != 0) {
+		mbedtls_pk_free(&entry->pk);
+		/*
+		 * The other cached keys may be holding the heap memory
+		 * needed to parse this one: drop them and try again.
+		 */
+		flush_cache();
+		entry = &pk_cache[0];
+		pk_cache_next = 1 % TF_MBEDTLS_PK_CACHE_SIZE;
+		mbedtls_pk_init(&entry->pk);
+		p = (unsigned char *)pk_ptr;
+		rc = mbedtls_pk_parse_subpubkey(&p, end, &entry->pk);
+		if (rc != 0) {
+			mbedtls_pk_free(&entry->pk);
+			return rc;
+		}
+	}
+
+	memcpy(entry->key_hash, key_hash, PK_HASH_SIZE);
+	entry->key_len = pk_len;
+	entry->valid = 1;
+	*pk = &entry->pk;
+
+	return 0;
+}
+
 /*
  * Verify a signature.
  *
@@ -60,7 +164,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk = {0};
+	mbedtls_pk_context *pk;
 	int rc;
 	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
@@ -81,14 +185,11 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Parse the public key */
-	mbedtls_pk_init(&pk);
-	p = (unsigned char *)pk_ptr;
-	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
+	/* Get the parsed public key */
+	rc = get_pk(pk_ptr, pk_len, &pk);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
-		goto end2;
+		goto end;
 	}
 
 	/* Get the signature (bitstring) */
@@ -98,7 +199,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	rc = mbedtls_asn1_get_bitstring_null(&p, end, &signature.len);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		goto end;
 	}
 	signature.p = p;
 
@@ -106,48 +207,44 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	md_info = mbedtls_md_info_from_type(md_alg);
 	if (md_info == NULL) {
 		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		goto end;
 	}
 	p = (unsigned char *)data_ptr;
 	rc = mbedtls_md(md_info, p, data_len, hash);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		goto end;
 	}
 
 	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
+	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, pk, md_alg, hash,
 			mbedtls_md_get_size(md_info),
 			signature.p, signature.len);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
-		goto end1;
+		goto end;
 	}
 
 	/* Signature verification success */
 	rc = CRYPTO_SUCCESS;
 
-end1:
-	mbedtls_pk_free(&pk);
-end2:
+end:
 	mbedtls_free(sig_opts);
 	return rc;
 }
 
 /*
- * Match a hash
- *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Parse a DigestInfo structure. On success, returns the hash algorithm and a
+ * pointer to the hash value, whose length matches the algorithm's size.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info_out,
+			   unsigned char **hash_out)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
 	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -186,7 +283,31 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	if (len != mbedtls_md_get_size(md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+
+	*md_info_out = md_info;
+	*hash_out = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -204,7 +325,112 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * State of the hash being computed over data supplied in chunks. The expected
+ * value is copied so that the caller's DigestInfo does not need to outlive
+ * hash_start().
+ */
+static mbedtls_md_context_t stream_md_ctx;
+static unsigned char stream_expected_hash[MBEDTLS_MD_MAX_SIZE];
+static size_t stream_hash_len;
+static int stream_active;
+
+static void hash_stream_free(void)
+{
+	if (stream_active != 0) {
+		mbedtls_md_free(&stream_md_ctx);
+		stream_active = 0;
+	}
+}
+
+/*
+ * Start matching a hash over data supplied in chunks
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int hash_start(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	/* Discard any operation that was not completed */
+	hash_stream_free();
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	mbedtls_md_init(&stream_md_ctx);
+	stream_active = 1;
+
+	rc = mbedtls_md_setup(&stream_md_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&stream_md_ctx);
+	}
+	if (rc != 0) {
+		hash_stream_free();
+		return CRYPTO_ERR_HASH;
+	}
+
+	stream_hash_len = mbedtls_md_get_size(md_info);
+	memcpy(stream_expected_hash, hash, stream_hash_len);
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Hash the next chunk of data
+ */
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	if (stream_active == 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_update(&stream_md_ctx, (unsigned char *)data_ptr,
+			       data_len);
+	if (rc != 0) {
+		hash_stream_free();
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the hash and compare it with the expected value
+ */
+static int hash_verify(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	if (stream_active == 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	rc = mbedtls_md_finish(&stream_md_ctx, data_hash);
+	hash_stream_free();
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, stream_expected_hash, stream_hash_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_EXT(LIB_NAME, init, verify_signature, verify_hash,
+			hash_start, hash_update, hash_verify, flush_cache);
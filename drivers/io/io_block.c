@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -236,6 +236,13 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * The underlying buffer is only needed for the blocks containing skip or
+ * padding bytes. When file_pos is block-aligned and the destination in the
+ * caller's buffer is block-aligned too, whole blocks are read directly into
+ * the caller's buffer, avoiding the extra copy. Such requests are still
+ * limited to the length of the underlying buffer, which is the transfer
+ * size the platform has set up its storage controller for.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -292,6 +299,25 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if ((skip == 0) && (left >= block_size) &&
+		    (((buffer + count) & (block_size - 1)) == 0)) {
+			/*
+			 * Neither skip nor padding bytes in the next
+			 * whole blocks, read them directly into the
+			 * user buffer.
+			 */
+			request = left & ~(block_size - 1);
+			if (request > buf->length)
+				request = buf->length;
+			nbytes = ops->read(lba, buffer + count, request);
+			if ((nbytes == 0) || (nbytes > request))
+				return -EIO;
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -27,16 +27,55 @@
 		x.node[0], x.node[1], x.node[2], x.node[3],			\
 		x.node[4], x.node[5]
 
+/*
+ * Maximum number of ToC entries (excluding the terminating null entry) that
+ * can be cached from the FIP header. Platforms packaging more images and
+ * certificates than this may override it in platform_def.h.
+ */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	32
+#endif
+
+/* Maximum number of files that can be open in the FIP at the same time */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		2
+#endif
+
 typedef struct {
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
 } file_state_t;
 
 static const uuid_t uuid_null = {0};
-static file_state_t current_file = {0};
+static file_state_t file_state_pool[MAX_FIP_FILES];
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
+/*
+ * Backend entity kept open while at least one file of the package is open,
+ * and the position of its cursor. Reads that continue where the previous one
+ * stopped are issued without seeking. The entity is not held between file
+ * accesses, as backends such as io_memmap only have a single entity and the
+ * platform opens it again to check the package (e.g. arm_io_is_toc_valid()
+ * followed by plat_get_image_source()).
+ */
+#define BACKEND_POS_UNKNOWN	SIZE_MAX
+static uintptr_t backend_handle;
+static size_t backend_pos = BACKEND_POS_UNKNOWN;
+
+/*
+ * In-memory copy of the ToC, sorted by UUID. It is populated on the first
+ * fip_dev_init() for a given package and reused by later initialisations of
+ * the same package, so that opening a file does not require reading the
+ * package header again. The extra slot holds the terminating null entry read
+ * from the package.
+ */
+static fip_toc_entry_t toc_entries[MAX_FIP_TOC_ENTRIES + 1];
+static unsigned int toc_entry_count;
+static unsigned int toc_image_id;
+static uintptr_t toc_dev_handle;
+static uintptr_t toc_image_spec;
+static int toc_valid;
 
 /* Firmware Image Package driver functions */
 static int fip_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
@@ -111,18 +150,134 @@ static int fip_dev_open(const uintptr_t dev_spec __unused,
 }
 
 
-/* Do some basic package checks. */
+/* Sort the cached ToC by UUID so that it can be searched with bisection */
+static void sort_toc_entries(void)
+{
+	fip_toc_entry_t tmp;
+	unsigned int i, j;
+
+	/* Insertion sort: the ToC is small and usually nearly sorted. */
+	for (i = 1; i < toc_entry_count; i++) {
+		tmp = toc_entries[i];
+		for (j = i; j > 0; j--) {
+			if (compare_uuids(&toc_entries[j - 1].uuid,
+					  &tmp.uuid) <= 0)
+				break;
+			toc_entries[j] = toc_entries[j - 1];
+		}
+		toc_entries[j] = tmp;
+	}
+}
+
+
+/* Look up a UUID in the cached ToC. Returns NULL if it is not present. */
+static const fip_toc_entry_t *find_toc_entry(const uuid_t *uuid)
+{
+	unsigned int low = 0, high = toc_entry_count;
+	unsigned int mid;
+	int cmp;
+
+	while (low < high) {
+		mid = low + ((high - low) / 2);
+		cmp = compare_uuids(&toc_entries[mid].uuid, uuid);
+		if (cmp == 0)
+			return &toc_entries[mid];
+		else if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return NULL;
+}
+
+
+/*
+ * Read the whole ToC from the backend into toc_entries[]. The backend handle
+ * must be positioned just after the FIP header.
+ */
+static int read_toc_entries(uintptr_t handle)
+{
+	int result;
+	size_t bytes_read;
+	unsigned int i, nr_read;
+
+	result = io_read(handle, (uintptr_t)toc_entries,
+			 sizeof(toc_entries), &bytes_read);
+	if (result != 0) {
+		WARN("Failed to read FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	nr_read = bytes_read / sizeof(fip_toc_entry_t);
+	for (i = 0; i < nr_read; i++) {
+		if (compare_uuids(&toc_entries[i].uuid, &uuid_null) == 0)
+			break;
+	}
+
+	if (i == nr_read) {
+		if (nr_read == ARRAY_SIZE(toc_entries)) {
+			WARN("FIP has more than %u ToC entries\n",
+				MAX_FIP_TOC_ENTRIES);
+			return -ENOMEM;
+		}
+		WARN("FIP ToC is truncated\n");
+		return -ENOENT;
+	}
+
+	toc_entry_count = i;
+	sort_toc_entries();
+
+	VERBOSE("FIP ToC cached, %u entries\n", toc_entry_count);
+
+	return 0;
+}
+
+
+/* Open the backend entity, unless it is already open */
+static int open_backend(void)
+{
+	int result;
+
+	if (backend_handle != (uintptr_t)NULL)
+		return 0;
+
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		backend_handle = (uintptr_t)NULL;
+		return result;
+	}
+
+	backend_pos = BACKEND_POS_UNKNOWN;
+
+	return 0;
+}
+
+
+/* Release the backend entity, if any */
+static void close_backend(void)
+{
+	if (backend_handle != (uintptr_t)NULL) {
+		io_close(backend_handle);
+		backend_handle = (uintptr_t)NULL;
+	}
+	backend_pos = BACKEND_POS_UNKNOWN;
+}
+
+
+/* Do some basic package checks and cache the Table of Contents. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
-	uintptr_t backend_handle;
+	uintptr_t dev_handle, image_spec;
 	fip_toc_header_t header;
 	size_t bytes_read;
+	int backend_was_open;
 
 	/* Obtain a reference to the image by querying the platform layer */
-	result = plat_get_image_source(image_id, &backend_dev_handle,
-				       &backend_image_spec);
+	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
 			image_id, result);
@@ -130,27 +285,69 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+	/* Drop the backend entity if the package now lives elsewhere */
+	if ((backend_dev_handle != dev_handle) ||
+	    (backend_image_spec != image_spec)) {
+		close_backend();
+	}
+
+	backend_dev_handle = dev_handle;
+	backend_image_spec = image_spec;
+
+	/*
+	 * The platform may have opened the backend device while resolving the
+	 * image source, which can move the cursor of devices that keep a
+	 * single state per device (e.g. io_block). Force the next read to seek.
+	 */
+	backend_pos = BACKEND_POS_UNKNOWN;
+
+	/* Nothing else to do if the ToC of this package is already cached */
+	if ((toc_valid != 0) && (toc_image_id == image_id) &&
+	    (toc_dev_handle == dev_handle) && (toc_image_spec == image_spec)) {
+		result = 0;
+		goto fip_dev_init_exit;
+	}
+
+	toc_valid = 0;
+	toc_entry_count = 0;
+
 	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	backend_was_open = (backend_handle != (uintptr_t)NULL);
+	result = open_backend();
 	if (result != 0) {
 		WARN("Failed to access image id=%u (%i)\n", image_id, result);
 		result = -ENOENT;
 		goto fip_dev_init_exit;
 	}
 
-	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
-			&bytes_read);
+	result = io_seek(backend_handle, IO_SEEK_SET, 0);
+	if (result == 0) {
+		result = io_read(backend_handle, (uintptr_t)&header,
+				 sizeof(header), &bytes_read);
+	}
 	if (result == 0) {
 		if (!is_valid_header(&header)) {
 			WARN("Firmware Image Package header check failed.\n");
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+			/* The ToC immediately follows the header */
+			result = read_toc_entries(backend_handle);
 		}
 	}
 
-	io_close(backend_handle);
+	if (result == 0) {
+		toc_image_id = image_id;
+		toc_dev_handle = dev_handle;
+		toc_image_spec = image_spec;
+		toc_valid = 1;
+	}
+
+	/* Only keep the backend entity if open files are using it */
+	if (backend_was_open == 0)
+		close_backend();
+	else
+		backend_pos = BACKEND_POS_UNKNOWN;
 
  fip_dev_init_exit:
 	return result;
@@ -159,9 +356,13 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 /* Close a connection to the FIP device */
 static int fip_dev_close(io_dev_info_t *dev_info)
 {
-	/* TODO: Consider tracking open files and cleaning them up here */
+	/*
+	 * The cached ToC is kept: callers close the device after each image
+	 * load and the next fip_dev_init() revalidates it against the backend.
+	 */
 
-	/* Clear the backend. */
+	/* Release and clear the backend, in case files were left open. */
+	close_backend();
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
 
@@ -169,83 +370,78 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 }
 
 
+/*
+ * Allocate a file state from the pool. We know the header lives at offset
+ * zero, so the entry offset should never be zero for an active file.
+ */
+static file_state_t *allocate_file_state(void)
+{
+	for (unsigned int i = 0; i < MAX_FIP_FILES; i++) {
+		if (file_state_pool[i].entry.offset_address == 0)
+			return &file_state_pool[i];
+	}
+
+	return NULL;
+}
+
+
+/* Return 1 if at least one file of the package is open, 0 otherwise */
+static int is_any_file_open(void)
+{
+	for (unsigned int i = 0; i < MAX_FIP_FILES; i++) {
+		if (file_state_pool[i].entry.offset_address != 0)
+			return 1;
+	}
+
+	return 0;
+}
+
+
 /* Open a file for access from package. */
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
-	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_toc_entry_t *toc_entry;
+	file_state_t *fp;
+	int result;
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return -ENOMEM;
+	if ((toc_valid == 0) || (backend_dev_handle == (uintptr_t)NULL)) {
+		WARN("fip_file_open: FIP device not initialised\n");
+		return -ENOENT;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+	toc_entry = find_toc_entry(&uuid_spec->uuid);
+	if (toc_entry == NULL) {
+		/* Did not find the file in the FIP. */
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
-	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
+	fp = allocate_file_state();
+	if (fp == NULL) {
+		WARN("fip_file_open: too many open files\n");
+		return -ENOMEM;
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-				break;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
-		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
-		result = -ENOENT;
+	/* The first open file brings up the backend entity */
+	result = open_backend();
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	/*
+	 * Update entity info with file state and return. Set the file position
+	 * to 0. The 'entry' holds the base and size of the file.
+	 */
+	fp->entry = *toc_entry;
+	fp->file_pos = 0;
+	entity->info = (uintptr_t)fp;
 
- fip_file_open_exit:
-	return result;
+	return 0;
 }
 
 
@@ -269,67 +465,69 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	file_state_t *fp;
 	size_t file_offset;
 	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
+	if (backend_handle == (uintptr_t)NULL) {
+		WARN("Failed to open FIP\n");
+		return -ENOENT;
 	}
 
 	fp = (file_state_t *)entity->info;
 
-	/* Seek to the position in the FIP where the payload lives */
+	/*
+	 * Seek to the position in the FIP where the payload lives, unless the
+	 * backend cursor is already there.
+	 */
 	file_offset = fp->entry.offset_address + fp->file_pos;
-	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
-	if (result != 0) {
-		WARN("fip_file_read: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_read_close;
+	if (file_offset != backend_pos) {
+		result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+		if (result != 0) {
+			WARN("fip_file_read: failed to seek\n");
+			backend_pos = BACKEND_POS_UNKNOWN;
+			return -ENOENT;
+		}
 	}
 
 	result = io_read(backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		backend_pos = BACKEND_POS_UNKNOWN;
+		return -ENOENT;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
+	backend_pos = file_offset + bytes_read;
 
- fip_file_read_exit:
-	return result;
+	return 0;
 }
 
 
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
-	 */
-	if (current_file.entry.offset_address != 0) {
-		zeromem(&current_file, sizeof(current_file));
-	}
+	file_state_t *fp;
+
+	assert(entity != NULL);
+
+	/* Return the file state to the pool. */
+	fp = (file_state_t *)entity->info;
+	if (fp != NULL)
+		zeromem(fp, sizeof(*fp));
 
 	/* Clear the Entity info. */
 	entity->info = 0;
 
+	/* Release the backend entity with the last open file */
+	if (is_any_file_open() == 0)
+		close_backend();
+
 	return 0;
 }
 
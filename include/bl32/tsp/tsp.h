@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -42,6 +42,14 @@
 #define TSP_DIV		0x2003
 #define TSP_HANDLE_SEL1_INTR_AND_RETURN	0x2004
 
+/*
+ * Service that does no work, to measure the cost of a round trip from the
+ * Normal world to the TSP and back. It returns in x1 the value of the physical
+ * counter read on entry into the TSP, so that the caller can also time the
+ * two halves of the round trip.
+ */
+#define TSP_NOP		0x2005
+
 /*
  * Identify a TSP service from function ID filtering the last 16 bits from the
  * SMC function ID
@@ -68,7 +76,7 @@
  * Total number of function IDs implemented for services offered to NS clients.
  * The function IDs are defined above
  */
-#define TSP_NUM_FID		0x5
+#define TSP_NUM_FID		0x6
 
 /* TSP implementation version numbers */
 #define TSP_VERSION_MAJOR	0x0 /* Major version */
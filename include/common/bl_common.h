@@ -88,6 +88,9 @@ extern uintptr_t __BL31_END__;
 extern uintptr_t __BL32_END__;
 #endif /* IMAGE_BLX */
 
+extern uintptr_t __RW_START__;
+extern uintptr_t __RW_END__;
+
 #if USE_COHERENT_MEM
 extern uintptr_t __COHERENT_RAM_START__;
 extern uintptr_t __COHERENT_RAM_END__;
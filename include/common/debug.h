@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,6 +25,7 @@
 
 #ifndef __ASSEMBLY__
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 
 /*
@@ -38,36 +39,112 @@
 #define LOG_MARKER_INFO			"\x28"	/* 40 */
 #define LOG_MARKER_VERBOSE		"\x32"	/* 50 */
 
+#if ENABLE_BINARY_LOG
+/*
+ * With ENABLE_BINARY_LOG, the log macros output compact binary records instead
+ * of formatting their message. The format string of each call site is placed
+ * in the TF_BLOG_FMT_SECTION section, which is kept in the ELF file of the
+ * image but not loaded, and is identified in the records by its offset in
+ * that section. The first byte of the section identifies the image. The
+ * arguments are output in their raw form, after the integer promotions and the
+ * conversion of arrays to pointers. The records are turned back into text on
+ * the host by tools/log_decoder. A record is made of:
+ *
+ *   - the TF_BLOG_MARKER byte, which cannot occur in text output;
+ *   - the identifier of the image, on one byte;
+ *   - the log level, on one byte;
+ *   - the offset of the format string, on 4 little-endian bytes;
+ *   - the number of arguments, on one byte;
+ *   - for each argument, its size on one byte followed by its bytes in
+ *     the memory order of the target.
+ */
+#define TF_BLOG_MARKER			0xfe
+#define TF_BLOG_FMT_SECTION		".tf_log_fmt"
+
+#define TF_BLOG_CAT_(a, b)		a##b
+#define TF_BLOG_CAT(a, b)		TF_BLOG_CAT_(a, b)
+
+/* Number of arguments following the format string, up to 9 */
+#define TF_BLOG_NARGS(...)						\
+	TF_BLOG_NARGS_(__VA_ARGS__, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 0)
+#define TF_BLOG_NARGS_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, a9, n, ...)	n
+
+#define TF_BLOG_FMT(...)		TF_BLOG_FMT_(__VA_ARGS__, 0)
+#define TF_BLOG_FMT_(fmt, ...)		fmt
+
+#define TF_BLOG_ARG(a)							\
+	{								\
+		__typeof__(0 ? (a) : (a)) __tf_blog_arg = (a);		\
+		tf_blog_arg(&__tf_blog_arg, sizeof(__tf_blog_arg));	\
+	}
+
+#define TF_BLOG_A0(f, ...)
+#define TF_BLOG_A1(f, a, ...)	TF_BLOG_ARG(a)
+#define TF_BLOG_A2(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A1(f, __VA_ARGS__)
+#define TF_BLOG_A3(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A2(f, __VA_ARGS__)
+#define TF_BLOG_A4(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A3(f, __VA_ARGS__)
+#define TF_BLOG_A5(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A4(f, __VA_ARGS__)
+#define TF_BLOG_A6(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A5(f, __VA_ARGS__)
+#define TF_BLOG_A7(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A6(f, __VA_ARGS__)
+#define TF_BLOG_A8(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A7(f, __VA_ARGS__)
+#define TF_BLOG_A9(f, a, ...)	TF_BLOG_ARG(a) TF_BLOG_A8(f, __VA_ARGS__)
+
+/*
+ * The format and the arguments are also passed to tf_blog_check_fmt() in dead
+ * code, so that the compiler still checks them against each other.
+ */
+#define TF_BLOG(log_level, ...)						\
+	do {								\
+		static const char __tf_blog_fmt[]			\
+			__section(TF_BLOG_FMT_SECTION) =		\
+			TF_BLOG_FMT(__VA_ARGS__);			\
+		if (0)							\
+			tf_blog_check_fmt(__VA_ARGS__);			\
+		if (tf_blog_start(log_level, (uintptr_t)__tf_blog_fmt,	\
+				  TF_BLOG_NARGS(__VA_ARGS__)) != 0) {	\
+			TF_BLOG_CAT(TF_BLOG_A, TF_BLOG_NARGS(__VA_ARGS__))	\
+				(__VA_ARGS__, 0)				\
+		}							\
+	} while (0)
+
+# define TF_LOG(log_level, log_marker, ...)	TF_BLOG(log_level, __VA_ARGS__)
+#else
+# define TF_LOG(log_level, log_marker, ...)	tf_log(log_marker __VA_ARGS__)
+#endif
+
 #if LOG_LEVEL >= LOG_LEVEL_NOTICE
-# define NOTICE(...)	tf_log(LOG_MARKER_NOTICE __VA_ARGS__)
+# define NOTICE(...)	TF_LOG(LOG_LEVEL_NOTICE, LOG_MARKER_NOTICE, __VA_ARGS__)
 #else
 # define NOTICE(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
-# define ERROR(...)	tf_log(LOG_MARKER_ERROR __VA_ARGS__)
+# define ERROR(...)	TF_LOG(LOG_LEVEL_ERROR, LOG_MARKER_ERROR, __VA_ARGS__)
 #else
 # define ERROR(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_WARNING
-# define WARN(...)	tf_log(LOG_MARKER_WARNING __VA_ARGS__)
+# define WARN(...)	TF_LOG(LOG_LEVEL_WARNING, LOG_MARKER_WARNING, __VA_ARGS__)
 #else
 # define WARN(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-# define INFO(...)	tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# define INFO(...)	TF_LOG(LOG_LEVEL_INFO, LOG_MARKER_INFO, __VA_ARGS__)
 #else
 # define INFO(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-# define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# define VERBOSE(...)	TF_LOG(LOG_LEVEL_VERBOSE, LOG_MARKER_VERBOSE, __VA_ARGS__)
 #else
 # define VERBOSE(...)
 #endif
 
+/* Character output function used by tf_vprintf_to() */
+typedef int (*tf_putc_t)(int c);
+
 void __dead2 do_panic(void);
 #define panic()	do_panic()
 
@@ -78,8 +155,23 @@ void tf_log(const char *fmt, ...) __printflike(1, 2);
 void tf_printf(const char *fmt, ...) __printflike(1, 2);
 int tf_snprintf(char *s, size_t n, const char *fmt, ...) __printflike(3, 4);
 void tf_vprintf(const char *fmt, va_list args);
+void tf_vprintf_to(tf_putc_t putc_fn, const char *fmt, va_list args);
 void tf_string_print(const char *str);
 void tf_log_set_max_level(unsigned int log_level);
+#if ENABLE_BINARY_LOG
+int tf_blog_start(unsigned int log_level, uintptr_t fmt_id, unsigned int nargs);
+void tf_blog_arg(const void *arg, unsigned int size);
+
+static inline void __printflike(1, 2) tf_blog_check_fmt(const char *fmt, ...)
+{
+}
+#endif
+#if ENABLE_LOG_RING && defined(IMAGE_BL31)
+void tf_log_ring_enable(void);
+int tf_log_ring_vlog(unsigned int log_level, const char *prefix_str,
+		     const char *fmt, va_list args);
+void tf_log_ring_flush(void);
+#endif
 
 #endif /* __ASSEMBLY__ */
 #endif /* __DEBUG_H__ */
@@ -38,6 +38,24 @@
  */
 #define MAX_RT_SVCS		128
 
+/*
+ * Statistics kept for each runtime service and SMC function ID when
+ * ENABLE_SMC_STATS is set. Latencies are accumulated in generic timer ticks
+ * and binned in log2 histograms, bucket 'n' counting the calls that took
+ * [2^(n-1), 2^n) ticks and the last bucket counting all the slower ones.
+ * A statistic is selected by one of the following queries, optionally ORed
+ * with RT_SVC_STATS_PER_SVC to get the totals of the runtime service that
+ * owns the function ID instead.
+ */
+#define RT_SVC_STATS_HIST_BUCKETS	16
+
+#define RT_SVC_STATS_COUNT		0x0
+#define RT_SVC_STATS_TICKS		0x1
+#define RT_SVC_STATS_FID		0x2
+#define RT_SVC_STATS_DROPPED		0x3
+#define RT_SVC_STATS_HIST(_n)		(0x100 + (_n))
+#define RT_SVC_STATS_PER_SVC		(1 << 16)
+
 #ifndef __ASSEMBLY__
 
 /* Prototype for runtime service initializing function */
@@ -128,5 +146,18 @@ void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 
+#if ENABLE_SMC_STATS
+uintptr_t rt_svc_stats_handle_smc(uint32_t smc_fid,
+				  u_register_t x1,
+				  u_register_t x2,
+				  u_register_t x3,
+				  u_register_t x4,
+				  void *cookie,
+				  void *handle,
+				  u_register_t flags);
+int rt_svc_stats_get(unsigned int cpu_idx, uint32_t smc_fid,
+		     unsigned int query, unsigned long long *value);
+#endif
+
 #endif /*__ASSEMBLY__*/
 #endif /* __RUNTIME_SVC_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -30,12 +30,24 @@ typedef struct auth_img_desc_s {
 	auth_param_desc_t authenticated_data[COT_MAX_VERIFIED_PARAMS];
 } auth_img_desc_t;
 
+/*
+ * Authentication statistics
+ */
+typedef struct auth_mod_stats_s {
+	unsigned int sig_verified;
+	unsigned int parent_auth_skipped;
+} auth_mod_stats_t;
+
 /* Public functions */
 void auth_mod_init(void);
 int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+void auth_mod_get_stats(auth_mod_stats_t *stats);
+int auth_mod_hash_start(unsigned int img_id);
+int auth_mod_hash_update(unsigned int img_id, void *data_ptr,
+			 unsigned int data_len);
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t */
 #define REGISTER_COT(_cot) \
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -37,6 +37,18 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional: verify a hash over data supplied in several chunks. Only
+	 * one such operation can be in progress at a time; starting a new one
+	 * discards the previous one. Return one of the
+	 * 'enum crypto_ret_value' options */
+	int (*hash_start)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_verify)(void);
+
+	/* Optional: release any state kept by the library between
+	 * verifications, e.g. parsed public keys */
+	void (*flush_cache)(void);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,6 +59,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_start(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_verify(void);
+void crypto_mod_flush_cache(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -57,4 +73,22 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/*
+ * Macro to register a cryptographic library that also provides the optional
+ * operations
+ */
+#define REGISTER_CRYPTO_LIB_EXT(_name, _init, _verify_signature, \
+				_verify_hash, _hash_start, _hash_update, \
+				_hash_verify, _flush_cache) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_start = _hash_start, \
+		.hash_update = _hash_update, \
+		.hash_verify = _hash_verify, \
+		.flush_cache = _flush_cache \
+	}
+
 #endif /* __CRYPTO_MOD_H__ */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __LOCK_PROF_H__
+#define __LOCK_PROF_H__
+
+/*
+ * Lock profiling is only supported in BL31. When it is enabled, spin_lock()
+ * and spin_unlock() are the profiling wrappers in lock_prof.c, and the
+ * assembly implementations are renamed.
+ */
+#if ENABLE_LOCK_PROF && defined(IMAGE_BL31)
+#define LOCK_PROF	1
+#else
+#define LOCK_PROF	0
+#endif
+
+/*
+ * Statistics kept for each registered lock when ENABLE_LOCK_PROF is set. Times
+ * are measured in generic timer ticks. A statistic is selected by one of the
+ * following queries. LOCK_PROF_NAME(n) returns the characters 8n to 8n + 7 of
+ * the registered name of the lock, the first one in the least significant
+ * byte, and LOCK_PROF_INDEX returns the index of the lock in the registered
+ * array of locks.
+ */
+#define LOCK_PROF_ACQUIRED		0x0
+#define LOCK_PROF_CONTENDED		0x1
+#define LOCK_PROF_SPIN_TICKS		0x2
+#define LOCK_PROF_MAX_SPIN_TICKS	0x3
+#define LOCK_PROF_MAX_HOLD_TICKS	0x4
+#define LOCK_PROF_INDEX			0x5
+#define LOCK_PROF_NAME(_n)		(0x100 + (_n))
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+
+/*
+ * Descriptor of an array of 'count' locks named 'name', the first one at
+ * 'first' and the others 'stride' bytes apart.
+ */
+typedef struct lock_prof_desc {
+	const char *name;
+	const void *first;
+	size_t stride;
+	unsigned int count;
+} lock_prof_desc_t;
+
+#if LOCK_PROF
+/*
+ * Convenience macros to register locks for profiling. Only the acquisitions
+ * of registered locks are recorded. A lock embedded in an array of structures
+ * is registered by passing the size of the structure as '_stride'.
+ */
+#define LOCK_PROF_REGISTER_ARRAY(_name, _first, _count, _stride)	\
+	static const lock_prof_desc_t __lock_prof_desc_ ## _name	\
+	__section("lock_prof_descs") __used = {				\
+		.name = #_name,						\
+		.first = (_first),					\
+		.stride = (_stride),					\
+		.count = (_count)					\
+	}
+
+void lock_prof_acquired(const void *lock, unsigned long long start,
+			int contended);
+void lock_prof_released(const void *lock);
+int lock_prof_get(unsigned int lock_idx, unsigned int query,
+		  unsigned long long *value);
+#else
+#define LOCK_PROF_REGISTER_ARRAY(_name, _first, _count, _stride)	\
+	extern const lock_prof_desc_t __lock_prof_desc_ ## _name
+#endif /* LOCK_PROF */
+
+#define LOCK_PROF_REGISTER(_name, _lock)				\
+	LOCK_PROF_REGISTER_ARRAY(_name, (_lock), 1, sizeof(*(_lock)))
+
+#endif /* __ASSEMBLY__ */
+#endif /* __LOCK_PROF_H__ */
@@ -26,6 +26,7 @@
  */
 #define PMF_STORE_ENABLE	(1 << 0)
 #define PMF_DUMP_ENABLE		(1 << 1)
+#define PMF_TRACE_ENABLE	(1 << 2)
 
 /*
  * Flags passed to PMF_GET_TIMESTAMP_XXX
@@ -39,7 +40,39 @@
  */
 #define PMF_SMC_GET_TIMESTAMP_32	0x82000010
 #define PMF_SMC_GET_TIMESTAMP_64	0xC2000010
-#define PMF_NUM_SMC_CALLS		2
+#define PMF_SMC_GET_SMC_STATS_32	0x82000011
+#define PMF_SMC_GET_SMC_STATS_64	0xC2000011
+#define PMF_SMC_TRACE_READ_32		0x82000012
+#define PMF_SMC_TRACE_READ_64		0xC2000012
+#define PMF_SMC_GET_LOCK_STATS_32	0x82000013
+#define PMF_SMC_GET_LOCK_STATS_64	0xC2000013
+#define PMF_SMC_GET_SPM_STATS_32	0x82000014
+#define PMF_SMC_GET_SPM_STATS_64	0xC2000014
+
+#if ENABLE_SMC_STATS
+#define PMF_NUM_SMC_STATS_CALLS		2
+#else
+#define PMF_NUM_SMC_STATS_CALLS		0
+#endif
+#if ENABLE_PMF_TRACE
+#define PMF_NUM_SMC_TRACE_CALLS		2
+#else
+#define PMF_NUM_SMC_TRACE_CALLS		0
+#endif
+#if ENABLE_LOCK_PROF
+#define PMF_NUM_SMC_LOCK_STATS_CALLS	2
+#else
+#define PMF_NUM_SMC_LOCK_STATS_CALLS	0
+#endif
+#if ENABLE_SPM
+#define PMF_NUM_SMC_SPM_STATS_CALLS	2
+#else
+#define PMF_NUM_SMC_SPM_STATS_CALLS	0
+#endif
+#define PMF_NUM_SMC_CALLS		(2 + PMF_NUM_SMC_STATS_CALLS +	\
+					 PMF_NUM_SMC_TRACE_CALLS +	\
+					 PMF_NUM_SMC_LOCK_STATS_CALLS +	\
+					 PMF_NUM_SMC_SPM_STATS_CALLS)
 
 /*
  * The macros below are used to identify
@@ -53,6 +86,40 @@
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
 
+/*
+ * Event ID recorded in the trace buffers for the timestamps captured by the
+ * services registered with PMF_TRACE_ENABLE.
+ */
+#define PMF_TRACE_EVENT_ID(_svcid, _tid)			\
+	((((_svcid) << PMF_SVC_ID_SHIFT) & PMF_SVC_ID_MASK) |	\
+	 (((_tid) << PMF_TID_SHIFT) & PMF_TID_MASK))
+
+/*
+ * Entry of the per-CPU trace buffers, as copied to the normal world by
+ * PMF_SMC_TRACE_READ.
+ */
+typedef struct pmf_trace_entry {
+	uint64_t ts;
+	uint64_t arg;
+	uint32_t event;
+	uint32_t reserved;
+} pmf_trace_entry_t;
+
+#if ENABLE_PMF_TRACE
+/*
+ * Convenience macros for recording an event in the trace buffer of the
+ * current CPU, with the current time or a given timestamp.
+ */
+#define PMF_TRACE_EVENT(_event, _arg)					\
+	__pmf_trace_event((_event), (_arg), read_cntpct_el0(), 0)
+
+#define PMF_TRACE_EVENT_TS(_event, _arg, _ts, _flags)			\
+	__pmf_trace_event((_event), (_arg), (_ts), (_flags))
+#else
+#define PMF_TRACE_EVENT(_event, _arg)			do { } while (0)
+#define PMF_TRACE_EVENT_TS(_event, _arg, _ts, _flags)	do { } while (0)
+#endif /* ENABLE_PMF_TRACE */
+
 #if ENABLE_PMF
 /*
  * Convenience macros for capturing time-stamp.
@@ -119,7 +186,7 @@
  */
 #define PMF_REGISTER_SERVICE(_name, _svcid, _totalid, _flags)	\
 	PMF_ALLOCATE_TIMESTAMP_MEMORY(_name, _totalid)		\
-	PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _flags)		\
+	PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _svcid, _flags)	\
 	PMF_DEFINE_GET_TIMESTAMP(_name)
 
 /*
@@ -172,5 +239,15 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		void *cookie,
 		void *handle,
 		u_register_t flags);
+#if ENABLE_PMF_TRACE
+int pmf_trace_read(unsigned int cpuid,
+		pmf_trace_entry_t *dst,
+		unsigned int max_entries,
+		unsigned int *num_entries,
+		unsigned long long *lost);
+int pmf_trace_read_smc(u_register_t mpidr,
+		unsigned int *num_entries,
+		unsigned long long *lost);
+#endif
 
 #endif /* __PMF_H__ */
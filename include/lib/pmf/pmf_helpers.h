@@ -66,7 +66,7 @@ typedef struct pmf_svc_desc {
  *
  * The extern declaration is there to satisfy MISRA C-2012 rule 8.4.
  */
-#define PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _flags)			\
+#define PMF_DEFINE_CAPTURE_TIMESTAMP(_name, _svcid, _flags)		\
 	void pmf_capture_timestamp_ ## _name(				\
 			unsigned int tid,				\
 			unsigned long long ts);				\
@@ -81,6 +81,9 @@ typedef struct pmf_svc_desc {
 			__pmf_store_timestamp(base_addr, tid, ts);	\
 		if ((_flags) & PMF_DUMP_ENABLE)				\
 			__pmf_dump_timestamp(tid, ts);			\
+		if ((_flags) & PMF_TRACE_ENABLE)			\
+			PMF_TRACE_EVENT_TS(PMF_TRACE_EVENT_ID(_svcid, tid),\
+					0, ts, 0);			\
 	}								\
 	void pmf_capture_timestamp_with_cache_maint_ ## _name(		\
 			unsigned int tid,				\
@@ -96,6 +99,9 @@ typedef struct pmf_svc_desc {
 			__pmf_store_timestamp_with_cache_maint(base_addr, tid, ts);\
 		if ((_flags) & PMF_DUMP_ENABLE)				\
 			__pmf_dump_timestamp(tid, ts);			\
+		if ((_flags) & PMF_TRACE_ENABLE)			\
+			PMF_TRACE_EVENT_TS(PMF_TRACE_EVENT_ID(_svcid, tid),\
+					0, ts, PMF_CACHE_MAINT);	\
 	}
 
 /*
@@ -159,4 +165,8 @@ unsigned long long __pmf_get_timestamp(uintptr_t base_addr,
 		unsigned int tid,
 		unsigned int cpuid,
 		unsigned int flags);
+void __pmf_trace_event(unsigned int event,
+		unsigned long long arg,
+		unsigned long long ts,
+		unsigned int flags);
 #endif /* __PMF_HELPERS_H__ */
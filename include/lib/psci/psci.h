@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -270,6 +270,15 @@ typedef struct psci_cpu_data {
 
 	/* The local power state of this CPU */
 	plat_local_state_t local_state;
+
+#if PSCI_LOCKLESS_SUSPEND
+	/*
+	 * Set while this CPU suspends without the power domain locks, from
+	 * the time it stops requesting RUN for its level 1 power domain until
+	 * the platform has been asked to suspend it.
+	 */
+	unsigned char lockless_suspend;
+#endif
 } psci_cpu_data_t;
 
 /*******************************************************************************
@@ -328,6 +337,9 @@ long psci_migrate_info_up_cpu(void);
 int psci_node_hw_state(u_register_t target_cpu,
 		       unsigned int power_level);
 int psci_features(unsigned int psci_fid);
+#if ENABLE_PSCI_STAT
+int psci_stat_snapshot(uintptr_t buf, size_t size, size_t *size_written);
+#endif
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 
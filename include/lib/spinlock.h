@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,21 @@
 #ifndef __SPINLOCK_H__
 #define __SPINLOCK_H__
 
+#include <lock_prof.h>
+
+/*
+ * A ticket lock holds the ticket being served in its lower half and the next
+ * ticket to hand out in its upper half.
+ */
+#define TICKET_LOCK_NEXT_SHIFT	16
+
+/* Offsets of the fields of an MCS lock queue node */
+#define MCS_NODE_NEXT		0
+#define MCS_NODE_LOCKED		8
+
 #ifndef __ASSEMBLY__
 
+#include <cassert.h>
 #include <types.h>
 
 typedef struct spinlock {
@@ -17,6 +30,45 @@ typedef struct spinlock {
 
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
+int spin_trylock(spinlock_t *lock);
+
+/* Ticket and MCS locks are only implemented for AArch64 */
+#ifndef AARCH32
+
+/*
+ * Ticket locks are fair: contenders acquire the lock in the order in which
+ * they tried to take it. They are the same size as spin locks.
+ */
+typedef struct ticket_lock {
+	volatile uint32_t lock;
+} ticket_lock_t;
+
+/*
+ * MCS locks queue their contenders, each of which waits on its own node rather
+ * than on the lock. The node must stay valid until the lock is released, and
+ * each lock held at the same time needs a distinct node.
+ */
+typedef struct mcs_node {
+	struct mcs_node *volatile next;
+	volatile uint32_t locked;
+} mcs_node_t;
+
+typedef struct mcs_lock {
+	mcs_node_t *volatile tail;
+} mcs_lock_t;
+
+CASSERT(MCS_NODE_NEXT == __builtin_offsetof(mcs_node_t, next),
+	assert_mcs_node_next_offset_mismatch);
+CASSERT(MCS_NODE_LOCKED == __builtin_offsetof(mcs_node_t, locked),
+	assert_mcs_node_locked_offset_mismatch);
+
+void ticket_lock(ticket_lock_t *lock);
+void ticket_unlock(ticket_lock_t *lock);
+
+void mcs_lock(mcs_lock_t *lock, mcs_node_t *node);
+void mcs_unlock(mcs_lock_t *lock, mcs_node_t *node);
+
+#endif /* AARCH32 */
 
 #else
 
@@ -95,6 +95,16 @@
 #define XLAT_BLOCK_MASK(level)	(XLAT_BLOCK_SIZE(level) - 1)
 /* Mask to get the address bits common to a block of a certain table level*/
 #define XLAT_ADDR_MASK(level)	(~XLAT_BLOCK_MASK(level))
+
+/*
+ * Number of adjacent entries of a translation table that form a contiguous
+ * group, which can be cached in a single TLB entry if their descriptors have
+ * the contiguous hint set. With the 4KB translation granule, it is the same
+ * at every lookup level.
+ */
+#define XLAT_CONT_ENTRIES	U(16)
+#define XLAT_CONT_SIZE(level)	(XLAT_CONT_ENTRIES * XLAT_BLOCK_SIZE(level))
+#define XLAT_CONT_MASK(level)	(XLAT_CONT_SIZE(level) - 1)
 /*
  * Extract from the given virtual address the index into the given lookup level.
  * This macro assumes the system is using the 4KB translation granule.
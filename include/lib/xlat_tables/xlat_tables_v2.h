@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -62,6 +62,11 @@
  * Privileged (EL1). In the EL3 translation regime this has no effect.
  */
 #define MT_USER_SHIFT		U(6)
+/*
+ * Allow or forbid the use of the contiguous hint in the translation tables
+ * that map the region (CONTIG_HINT/NO_CONTIG_HINT).
+ */
+#define MT_CONTIG_SHIFT		U(7)
 /* All other bits are reserved */
 
 /*
@@ -102,6 +107,22 @@ typedef enum  {
 	 */
 	MT_USER				= U(1) << MT_USER_SHIFT,
 	MT_PRIVILEGED			= U(0) << MT_USER_SHIFT,
+
+	/*
+	 * Naturally aligned groups of XLAT_CONT_ENTRIES blocks or pages of the
+	 * region are marked with the contiguous hint, so that each group only
+	 * uses one TLB entry. The groups never span several regions, and the
+	 * hint is removed from a group when change_mem_attributes() changes
+	 * part of it. To do so, change_mem_attributes() briefly unmaps the
+	 * entries of the group outside of the range it is given, i.e. up to
+	 * XLAT_CONT_ENTRIES - 1 blocks or pages on each side of it. Use
+	 * MT_NO_CONTIG_HINT for a region whose neighbouring memory may be
+	 * accessed while part of it is changed, such as translation tables
+	 * shared with a Secure Partition. MT_NO_CONTIG_HINT keeps every block or
+	 * page of the region in a TLB entry of its own.
+	 */
+	MT_CONTIG_HINT			= U(0) << MT_CONTIG_SHIFT,
+	MT_NO_CONTIG_HINT		= U(1) << MT_CONTIG_SHIFT,
 } mmap_attr_t;
 
 /* Compound attributes for most common usages */
@@ -267,10 +288,13 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  *
  * The base address of the memory region must be aligned on a page boundary.
  * The size of this memory region must be a multiple of a page size.
- * The memory region must be already mapped by the given translation tables
- * and it must be mapped at the granularity of a page.
+ * The memory region must be already mapped by the given translation tables.
+ * Blocks that the region covers partially are split into smaller blocks or
+ * pages, which uses free translation tables of the context.
  *
- * Return 0 on success, a negative value on error.
+ * Return 0 on success, a negative value on error: -EINVAL if the arguments
+ * are invalid, -ENOMEM if there aren't enough free translation tables to split
+ * the blocks.
  *
  * In case of error, the memory attributes remain unchanged and this function
  * has no effect.
@@ -297,6 +321,16 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
  * NOTE2: The caller is responsible for making sure that the targeted
  * translation tables are not modified by any other code while this function is
  * executing.
+ *
+ * NOTE3: The whole memory region is unmapped while its translation table
+ * entries are being rewritten, so neither the calling CPU nor any other one
+ * may access it while this function is executing. If the region is mapped
+ * with the contiguous hint (see MT_CONTIG_HINT), the entries of the contiguous
+ * groups that overlap its ends are unmapped too, i.e. up to
+ * XLAT_CONT_ENTRIES - 1 (15 with 4KB pages) blocks or pages on each side of
+ * the region, outside of it. The same restriction applies to that memory,
+ * which matters when the translation tables are shared, e.g. with a Secure
+ * Partition.
  */
 int change_mem_attributes(xlat_ctx_t *ctx, uintptr_t base_va, size_t size,
 			mmap_attr_t attr);
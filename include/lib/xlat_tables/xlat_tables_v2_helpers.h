@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -73,6 +73,14 @@ struct xlat_ctx {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+
+	/*
+	 * Stack of the indices of the tables that aren't used by any region,
+	 * so that tables can be allocated and freed in constant time.
+	 * `tables_free_num` is the number of indices in the stack.
+	 */
+	unsigned int *tables_free;
+	unsigned int tables_free_num;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 	unsigned int next_table;
@@ -109,10 +117,12 @@ struct xlat_ctx {
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 #define _ALLOC_DYNMAP_STRUCT(_ctx_name, _xlat_tables_count)		\
-	static int _ctx_name##_mapped_regions[_xlat_tables_count];
+	static int _ctx_name##_mapped_regions[_xlat_tables_count];	\
+	static unsigned int _ctx_name##_free_tables[_xlat_tables_count];
 
 #define _REGISTER_DYNMAP_STRUCT(_ctx_name)				\
-	.tables_mapped_regions = _ctx_name##_mapped_regions,
+	.tables_mapped_regions = _ctx_name##_mapped_regions,		\
+	.tables_free = _ctx_name##_free_tables,
 #else
 #define _ALLOC_DYNMAP_STRUCT(_ctx_name, _xlat_tables_count)		\
 	/* do nothing */
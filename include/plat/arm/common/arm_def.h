@@ -144,6 +144,16 @@
 #define ARM_NS_DRAM1_END		(ARM_NS_DRAM1_BASE +		\
 					 ARM_NS_DRAM1_SIZE - 1)
 
+/*
+ * Non-secure memory at the top of DRAM1 that BL31 copies bulk data to, e.g. the
+ * PMF trace events, for the Normal world to read. The Normal world must reserve
+ * it. Its size and alignment let it be mapped with a single block descriptor.
+ */
+#define ARM_NS_SHARED_MEM_SIZE		ULL(0x00200000)
+#define ARM_NS_SHARED_MEM_BASE		(ARM_NS_DRAM1_BASE +		\
+					 ARM_NS_DRAM1_SIZE -		\
+					 ARM_NS_SHARED_MEM_SIZE)
+
 #define ARM_DRAM1_BASE			ULL(0x80000000)
 #define ARM_DRAM1_SIZE			ULL(0x80000000)
 #define ARM_DRAM1_END			(ARM_DRAM1_BASE +		\
@@ -217,6 +227,11 @@
 						ARM_NS_DRAM1_SIZE,	\
 						MT_MEMORY | MT_RW | MT_NS)
 
+#define ARM_MAP_NS_SHARED_MEM		MAP_REGION_FLAT(		\
+						ARM_NS_SHARED_MEM_BASE,	\
+						ARM_NS_SHARED_MEM_SIZE,	\
+						MT_MEMORY | MT_RW | MT_NS)
+
 #define ARM_MAP_DRAM2			MAP_REGION_FLAT(		\
 						ARM_DRAM2_BASE,		\
 						ARM_DRAM2_SIZE,		\
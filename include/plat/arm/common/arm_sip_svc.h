@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,8 +17,15 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	0x82000020
 
+/* Function IDs for writing a snapshot of the PSCI stats to a buffer */
+#define ARM_SIP_SVC_PSCI_STAT_SNAPSHOT_32	0x82000021
+#define ARM_SIP_SVC_PSCI_STAT_SNAPSHOT_64	0xC2000021
+
+/* Function ID for outputting the pending log messages to the consoles */
+#define ARM_SIP_SVC_LOG_FLUSH		0x82000022
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		0x0
-#define ARM_SIP_SVC_VERSION_MINOR		0x2
+#define ARM_SIP_SVC_VERSION_MINOR		0x4
 
 #endif /* __ARM_SIP_SVC_H__ */
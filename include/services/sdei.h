@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -116,7 +116,8 @@
 
 /*
  * Declare shared and private entries for each core. Also declare a global
- * structure containing private and share entries.
+ * structure containing private and share entries, and the per-mapping arrays
+ * used to index the mappings by interrupt number.
  *
  * This macro must be used in the same file as the platform SDEI mappings are
  * declared. Only then would ARRAY_SIZE() yield a meaningful value.
@@ -125,13 +126,17 @@
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
+	static sdei_ev_map_t *sdei_private_intr_index[ARRAY_SIZE(_private)]; \
+	static sdei_ev_map_t *sdei_shared_intr_index[ARRAY_SIZE(_shared)]; \
 	const sdei_mapping_t sdei_global_mappings[] = { \
 		[_SDEI_MAP_IDX_PRIV] = { \
 			.map = _private, \
+			.intr_index = sdei_private_intr_index, \
 			.num_maps = ARRAY_SIZE(_private) \
 		}, \
 		[_SDEI_MAP_IDX_SHRD] = { \
 			.map = _shared, \
+			.intr_index = sdei_shared_intr_index, \
 			.num_maps = ARRAY_SIZE(_shared) \
 		}, \
 	}
@@ -160,6 +165,12 @@ typedef struct sdei_ev_map {
 
 typedef struct sdei_mapping {
 	sdei_ev_map_t *map;
+
+	/*
+	 * Pointers to the maps, statically bound ones first in increasing
+	 * order of interrupt number, followed by the dynamic ones.
+	 */
+	sdei_ev_map_t **intr_index;
 	size_t num_maps;
 } sdei_mapping_t;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -59,8 +59,9 @@ typedef struct secure_partition_boot_info {
 	secure_partition_mp_info_t	*mp_info;
 } secure_partition_boot_info_t;
 
-/* Setup function for secure partitions context. */
+/* Setup functions for secure partitions context. */
 
 void secure_partition_setup(void);
+void secure_partition_context_setup(unsigned int ctx_idx);
 
 #endif /* __SECURE_PARTITION_H__ */
@@ -59,11 +59,19 @@
 #define SPM_DENIED		-3
 #define SPM_NO_MEMORY		-5
 
+/*
+ * Statistics returned by spm_stats_get(), and by PMF_SMC_GET_SPM_STATS when
+ * the PMF SMCs are exposed.
+ */
+#define SPM_STATS_REQUESTS	0x0
+#define SPM_STATS_CONTENDED	0x1
+
 #ifndef __ASSEMBLY__
 
 #include <stdint.h>
 
 int32_t spm_setup(void);
+int spm_stats_get(unsigned int query, unsigned long long *value);
 
 uint64_t spm_smc_handler(uint32_t smc_fid,
 			 uint64_t x1,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -41,6 +41,9 @@ void cm_init(void)
 	 * The context management library has only global data to intialize, but
 	 * that will be done when the BSS is zeroed out
 	 */
+#if CTX_LAZY_FPREGS
+	cm_fpregs_reset();
+#endif
 }
 
 /*******************************************************************************
@@ -471,6 +474,49 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 #endif
 }
 
+/*******************************************************************************
+ * The next two functions are variants of the above that only save and restore
+ * the subset of the EL1 context that defines the execution environment of the
+ * world (see el1_sysregs_partial_context_save()). A runtime service can use
+ * them around calls during which the other world is known not to access the
+ * remaining EL1 registers, which then keep the values of the world that last
+ * used them. Both worlds must be switched with the same variant for a given
+ * call.
+ ******************************************************************************/
+void cm_el1_sysregs_context_save_partial(uint32_t security_state)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+
+	el1_sysregs_partial_context_save(get_sysregs_ctx(ctx));
+
+#if IMAGE_BL31
+	if (security_state == SECURE)
+		PUBLISH_EVENT(cm_exited_secure_world);
+	else
+		PUBLISH_EVENT(cm_exited_normal_world);
+#endif
+}
+
+void cm_el1_sysregs_context_restore_partial(uint32_t security_state)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+
+	el1_sysregs_partial_context_restore(get_sysregs_ctx(ctx));
+
+#if IMAGE_BL31
+	if (security_state == SECURE)
+		PUBLISH_EVENT(cm_entering_secure_world);
+	else
+		PUBLISH_EVENT(cm_entering_normal_world);
+#endif
+}
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
@@ -571,3 +617,114 @@ void cm_set_next_eret_context(uint32_t security_state)
 
 	cm_set_next_context(ctx);
 }
+
+#if CTX_INCLUDE_FPREGS
+#if CTX_LAZY_FPREGS
+/*
+ * Security state whose FP/SIMD registers are live on each CPU. Accesses from
+ * the other security state are trapped to EL3 by CPTR_EL3.TFP, which switches
+ * the registers on demand.
+ */
+#define FPREGS_OWNER_NONE	U(0xffffffff)
+
+static uint32_t fpregs_owner[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function records that no security state's FP/SIMD registers are live on
+ * the calling CPU, e.g. after it has been powered up, and traps all accesses
+ * until a security state claims them.
+ ******************************************************************************/
+void cm_fpregs_reset(void)
+{
+	fpregs_owner[plat_my_core_pos()] = FPREGS_OWNER_NONE;
+
+	write_cptr_el3(read_cptr_el3() | TFP_BIT);
+}
+
+/*******************************************************************************
+ * This function is called from the EL3 exception vectors when the lower EL
+ * accesses the FP/SIMD registers while they are trapped. It saves the live
+ * registers in the context of their owner, loads those of the security state
+ * that caused the trap and makes it the owner. The trapped instruction is
+ * executed again upon return.
+ ******************************************************************************/
+void cm_fpregs_trap_handler(void)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	uint32_t owner = fpregs_owner[core_pos];
+	uint32_t security_state;
+
+	security_state = (read_scr_el3() & SCR_NS_BIT) ? NON_SECURE : SECURE;
+	assert(owner != security_state);
+
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	if (owner != FPREGS_OWNER_NONE)
+		fpregs_context_save(get_fpregs_ctx(cm_get_context(owner)));
+
+	fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+	fpregs_owner[core_pos] = security_state;
+}
+
+#if IMAGE_BL31
+/*
+ * Save the live FP/SIMD registers before the CPU is powered down, as the
+ * owner expects to find them on resume.
+ */
+static void *cm_fpregs_pwrdown_save(const void *arg)
+{
+	uint32_t owner = fpregs_owner[plat_my_core_pos()];
+
+	if (owner != FPREGS_OWNER_NONE) {
+		write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+		isb();
+		fpregs_context_save(get_fpregs_ctx(cm_get_context(owner)));
+	}
+
+	cm_fpregs_reset();
+
+	return (void *)0;
+}
+
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_start, cm_fpregs_pwrdown_save);
+#endif /* IMAGE_BL31 */
+#endif /* CTX_LAZY_FPREGS */
+
+/*******************************************************************************
+ * The next two functions are used by runtime services to switch the FP/SIMD
+ * registers between security states. The save function must be called for the
+ * security state that is exited before calling the restore function for the
+ * one that is entered.
+ *
+ * With CTX_LAZY_FPREGS, the registers are left in place instead and only the
+ * trap on FP/SIMD accesses is set up, unless the entered security state
+ * already owns them. The trap is not set up on the other world switch paths,
+ * so a runtime service that switches worlds must call these functions on every
+ * switch. The build only allows CTX_LAZY_FPREGS with the Trusty dispatcher,
+ * which is the only one that does.
+ ******************************************************************************/
+void cm_fpregs_context_save(uint32_t security_state)
+{
+#if !CTX_LAZY_FPREGS
+	fpregs_context_save(get_fpregs_ctx(cm_get_context(security_state)));
+#endif
+}
+
+void cm_fpregs_context_restore(uint32_t security_state)
+{
+#if CTX_LAZY_FPREGS
+	uint64_t cptr = read_cptr_el3();
+
+	if (fpregs_owner[plat_my_core_pos()] == security_state)
+		cptr &= ~TFP_BIT;
+	else
+		cptr |= TFP_BIT;
+
+	/* No explicit ISB required here as ERET covers it */
+	write_cptr_el3(cptr);
+#else
+	fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+#endif
+}
+#endif /* CTX_INCLUDE_FPREGS */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -94,6 +94,10 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	unsigned int my_ticket, my_prio, their_ticket;
 	unsigned int their_bakery_data;
 
+#if LOCK_PROF
+	unsigned long long start = read_cntpct_el0();
+#endif
+
 	me = plat_my_core_pos();
 
 	assert_bakery_entry_valid(me, bakery);
@@ -134,6 +138,10 @@ void bakery_lock_get(bakery_lock_t *bakery)
 		}
 	}
 	/* Lock acquired */
+#if LOCK_PROF
+	/* Other CPUs were contending for the lock if they had a ticket */
+	lock_prof_acquired(bakery, start, my_ticket > 1);
+#endif
 }
 
 
@@ -145,6 +153,10 @@ void bakery_lock_release(bakery_lock_t *bakery)
 	assert_bakery_entry_valid(me, bakery);
 	assert(bakery_ticket_number(bakery->lock_data[me]));
 
+#if LOCK_PROF
+	lock_prof_released(bakery);
+#endif
+
 	/*
 	 * Release lock by resetting ticket. Then signal other
 	 * waiting contenders
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -153,6 +153,10 @@ void bakery_lock_get(bakery_lock_t *lock)
 	bakery_info_t *their_bakery_info;
 	unsigned int their_bakery_data;
 
+#if LOCK_PROF
+	unsigned long long start = read_cntpct_el0();
+#endif
+
 	me = plat_my_core_pos();
 #ifdef AARCH32
 	is_cached = read_sctlr() & SCTLR_C_BIT;
@@ -205,6 +209,10 @@ void bakery_lock_get(bakery_lock_t *lock)
 		}
 	}
 	/* Lock acquired */
+#if LOCK_PROF
+	/* Other CPUs were contending for the lock if they had a ticket */
+	lock_prof_acquired(lock, start, my_ticket > 1);
+#endif
 }
 
 void bakery_lock_release(bakery_lock_t *lock)
@@ -220,6 +228,10 @@ void bakery_lock_release(bakery_lock_t *lock)
 
 	assert(is_lock_acquired(my_bakery_info, is_cached));
 
+#if LOCK_PROF
+	lock_prof_released(lock);
+#endif
+
 	my_bakery_info->lock_data = 0;
 	write_cache_op(my_bakery_info, is_cached);
 	sev();
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <errno.h>
+#include <lock_prof.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <utils_def.h>
+
+/*
+ * Number of registered locks for which statistics are kept. Locks registered
+ * beyond this limit are not profiled.
+ */
+#ifndef PLAT_LOCK_PROF_MAX_LOCKS
+#define PLAT_LOCK_PROF_MAX_LOCKS	32
+#endif
+
+extern const lock_prof_desc_t __LOCK_PROF_DESCS_START__[];
+extern const lock_prof_desc_t __LOCK_PROF_DESCS_END__[];
+
+typedef struct lock_prof_stats {
+	unsigned long long acquired;
+	unsigned long long contended;
+	unsigned long long spin_ticks;
+	unsigned long long max_spin_ticks;
+	unsigned long long max_hold_ticks;
+	unsigned long long hold_start;
+} lock_prof_stats_t;
+
+/*
+ * Statistics of a CPU. Only the owning CPU updates them, so they are kept in
+ * their own cache lines and updated without locking, even when the CPU is not
+ * coherent yet. They are summed up across CPUs when read.
+ */
+typedef struct lock_prof_cpu {
+	lock_prof_stats_t locks[PLAT_LOCK_PROF_MAX_LOCKS];
+} __aligned(CACHE_WRITEBACK_GRANULE) lock_prof_cpu_t;
+
+static lock_prof_cpu_t lock_prof_stats[PLATFORM_CORE_COUNT];
+
+/*
+ * Find the index of a lock among the registered ones, as the position of its
+ * descriptor plus its index in the described array. Returns -1 if the lock is
+ * not registered or beyond PLAT_LOCK_PROF_MAX_LOCKS.
+ */
+static int lock_prof_find(const void *lock)
+{
+	const lock_prof_desc_t *desc;
+	uintptr_t offset;
+	unsigned int idx = 0;
+
+	for (desc = __LOCK_PROF_DESCS_START__;
+	     desc < __LOCK_PROF_DESCS_END__; desc++) {
+		offset = (uintptr_t)lock - (uintptr_t)desc->first;
+
+		if ((offset < desc->count * desc->stride) &&
+		    ((offset % desc->stride) == 0)) {
+			idx += offset / desc->stride;
+			break;
+		}
+
+		idx += desc->count;
+	}
+
+	if ((desc == __LOCK_PROF_DESCS_END__) ||
+	    (idx >= PLAT_LOCK_PROF_MAX_LOCKS))
+		return -1;
+
+	return idx;
+}
+
+/*
+ * Return the statistics of a lock for the calling CPU, or NULL if they must
+ * not be recorded. The statistics of a CPU running with its data cache
+ * disabled, e.g. while it is powering down, would not be coherent with its own
+ * cached copy, so they are not recorded.
+ */
+static lock_prof_stats_t *lock_prof_my_stats(const void *lock)
+{
+	int idx;
+
+	if ((read_sctlr_el3() & SCTLR_C_BIT) == 0)
+		return NULL;
+
+	idx = lock_prof_find(lock);
+	if (idx < 0)
+		return NULL;
+
+	return &lock_prof_stats[plat_my_core_pos()].locks[idx];
+}
+
+/*******************************************************************************
+ * Record the acquisition of a lock that the calling CPU started to wait for at
+ * 'start'. 'contended' is set if the lock was held by another CPU at that time.
+ ******************************************************************************/
+void lock_prof_acquired(const void *lock, unsigned long long start,
+			int contended)
+{
+	lock_prof_stats_t *stats = lock_prof_my_stats(lock);
+	unsigned long long now = read_cntpct_el0();
+
+	if (stats == NULL)
+		return;
+
+	stats->acquired++;
+	if (contended)
+		stats->contended++;
+	stats->spin_ticks += now - start;
+	stats->max_spin_ticks = MAX(stats->max_spin_ticks, now - start);
+	stats->hold_start = now;
+}
+
+/*******************************************************************************
+ * Record the release of a lock held by the calling CPU.
+ ******************************************************************************/
+void lock_prof_released(const void *lock)
+{
+	lock_prof_stats_t *stats = lock_prof_my_stats(lock);
+	unsigned long long hold_ticks;
+
+	/* Ignore the locks whose acquisition was not recorded */
+	if ((stats == NULL) || (stats->hold_start == 0))
+		return;
+
+	hold_ticks = read_cntpct_el0() - stats->hold_start;
+	stats->max_hold_ticks = MAX(stats->max_hold_ticks, hold_ticks);
+	stats->hold_start = 0;
+}
+
+/*******************************************************************************
+ * Retrieve the statistic selected by 'query' for the registered lock
+ * 'lock_idx', summed up or maximised across all CPUs. Returns -EINVAL once
+ * 'lock_idx' is past the last registered lock, which allows the caller to
+ * enumerate them.
+ ******************************************************************************/
+int lock_prof_get(unsigned int lock_idx, unsigned int query,
+		  unsigned long long *value)
+{
+	const lock_prof_desc_t *desc;
+	const lock_prof_stats_t *stats;
+	unsigned int i, idx = lock_idx;
+	unsigned long long v = 0;
+
+	assert(value != NULL);
+
+	/* The value is returned to the caller even when the query fails */
+	*value = 0;
+
+	if (lock_idx >= PLAT_LOCK_PROF_MAX_LOCKS)
+		return -EINVAL;
+
+	for (desc = __LOCK_PROF_DESCS_START__;
+	     desc < __LOCK_PROF_DESCS_END__; desc++) {
+		if (idx < desc->count)
+			break;
+		idx -= desc->count;
+	}
+
+	if (desc == __LOCK_PROF_DESCS_END__)
+		return -EINVAL;
+
+	if (query == LOCK_PROF_INDEX) {
+		*value = idx;
+		return 0;
+	}
+
+	if ((query >= LOCK_PROF_NAME(0)) && (query <= LOCK_PROF_NAME(0xff))) {
+		const char *name = desc->name;
+
+		/* Skip to the requested characters, stopping at the end */
+		for (i = 0; (i < (query - LOCK_PROF_NAME(0)) * 8U) &&
+			    (*name != '\0'); i++)
+			name++;
+
+		for (i = 0; (i < 8U) && (name[i] != '\0'); i++)
+			v |= (unsigned long long)(unsigned char)name[i] <<
+				(i * 8U);
+
+		*value = v;
+		return 0;
+	}
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		stats = &lock_prof_stats[i].locks[lock_idx];
+
+		if (query == LOCK_PROF_ACQUIRED)
+			v += stats->acquired;
+		else if (query == LOCK_PROF_CONTENDED)
+			v += stats->contended;
+		else if (query == LOCK_PROF_SPIN_TICKS)
+			v += stats->spin_ticks;
+		else if (query == LOCK_PROF_MAX_SPIN_TICKS)
+			v = MAX(v, stats->max_spin_ticks);
+		else if (query == LOCK_PROF_MAX_HOLD_TICKS)
+			v = MAX(v, stats->max_hold_ticks);
+		else
+			return -EINVAL;
+	}
+
+	*value = v;
+	return 0;
+}
+
+/*
+ * Spin lock wrappers, recording the time spent waiting for the lock and the
+ * time it is held. The lock is deemed contended if it is held when the CPU
+ * starts waiting for it.
+ */
+void __spin_lock(spinlock_t *lock);
+void __spin_unlock(spinlock_t *lock);
+
+static int spin_lock_is_held(const spinlock_t *lock)
+{
+	uint32_t val = lock->lock;
+
+#if USE_TICKET_SPINLOCKS
+	/* Held when the ticket being served is not the next one to hand out */
+	return ((val ^ (val >> TICKET_LOCK_NEXT_SHIFT)) &
+		((1U << TICKET_LOCK_NEXT_SHIFT) - 1U)) != 0U;
+#else
+	return val != 0U;
+#endif
+}
+
+void spin_lock(spinlock_t *lock)
+{
+	unsigned long long start = read_cntpct_el0();
+	int contended = spin_lock_is_held(lock);
+
+	__spin_lock(lock);
+	lock_prof_acquired(lock, start, contended);
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	lock_prof_released(lock);
+	__spin_unlock(lock);
+}
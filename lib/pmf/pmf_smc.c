@@ -1,13 +1,35 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
+#include <lock_prof.h>
 #include <platform.h>
 #include <pmf.h>
+#include <runtime_svc.h>
 #include <smcc_helpers.h>
+#include <spm_svc.h>
+
+#if ENABLE_SMC_STATS
+/*
+ * Retrieve a runtime service statistic of the CPU identified by 'mpidr'.
+ */
+static int pmf_get_smc_stats_smc(unsigned int smc_fid, u_register_t mpidr,
+				 unsigned int query, unsigned long long *value)
+{
+	int cpu_idx = plat_core_pos_by_mpidr(mpidr);
+
+	if (cpu_idx < 0) {
+		*value = 0;
+		return -EINVAL;
+	}
+
+	return rt_svc_stats_get(cpu_idx, smc_fid, query, value);
+}
+#endif
 
 /*
  * This function is responsible for handling all PMF SMC calls.
@@ -23,6 +45,19 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 {
 	int rc;
 	unsigned long long ts_value;
+#if ENABLE_SMC_STATS
+	unsigned long long stats_value;
+#endif
+#if LOCK_PROF
+	unsigned long long lock_value;
+#endif
+#if ENABLE_SPM
+	unsigned long long spm_value;
+#endif
+#if ENABLE_PMF_TRACE
+	unsigned int num_entries;
+	unsigned long long lost;
+#endif
 
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 
@@ -42,6 +77,59 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			SMC_RET3(handle, rc, (uint32_t)ts_value,
 					(uint32_t)(ts_value >> 32));
 
+#if ENABLE_SMC_STATS
+		case PMF_SMC_GET_SMC_STATS_32:
+			/*
+			 * Return error code and the requested
+			 * SMC statistic to the caller.
+			 * x0 --> error code.
+			 * x1 - x2 --> statistic value.
+			 */
+			rc = pmf_get_smc_stats_smc(x1, x2, x3, &stats_value);
+			SMC_RET3(handle, rc, (uint32_t)stats_value,
+					(uint32_t)(stats_value >> 32));
+#endif
+
+#if ENABLE_PMF_TRACE
+		case PMF_SMC_TRACE_READ_32:
+			/*
+			 * Copy the trace events of the CPU to the
+			 * buffer shared with the normal world.
+			 * x0 --> error code.
+			 * x1 --> number of events copied.
+			 * x2 --> number of events lost.
+			 */
+			rc = pmf_trace_read_smc(x1, &num_entries, &lost);
+			SMC_RET3(handle, rc, num_entries,
+					(lost > UINT32_MAX) ? UINT32_MAX : lost);
+#endif
+
+#if LOCK_PROF
+		case PMF_SMC_GET_LOCK_STATS_32:
+			/*
+			 * Return error code and the requested
+			 * lock statistic to the caller.
+			 * x0 --> error code.
+			 * x1 - x2 --> statistic value.
+			 */
+			rc = lock_prof_get(x1, x2, &lock_value);
+			SMC_RET3(handle, rc, (uint32_t)lock_value,
+					(uint32_t)(lock_value >> 32));
+#endif
+
+#if ENABLE_SPM
+		case PMF_SMC_GET_SPM_STATS_32:
+			/*
+			 * Return error code and the requested
+			 * Secure Partition statistic to the caller.
+			 * x0 --> error code.
+			 * x1 - x2 --> statistic value.
+			 */
+			rc = spm_stats_get(x1, &spm_value);
+			SMC_RET3(handle, rc, (uint32_t)spm_value,
+					(uint32_t)(spm_value >> 32));
+#endif
+
 		default:
 			break;
 		}
@@ -57,6 +145,55 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 			rc = pmf_get_timestamp_smc(x1, x2, x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 
+#if ENABLE_SMC_STATS
+		case PMF_SMC_GET_SMC_STATS_64:
+			/*
+			 * Return error code and the requested
+			 * SMC statistic to the caller.
+			 * x0 --> error code.
+			 * x1 --> statistic value.
+			 */
+			rc = pmf_get_smc_stats_smc(x1, x2, x3, &stats_value);
+			SMC_RET2(handle, rc, stats_value);
+#endif
+
+#if ENABLE_PMF_TRACE
+		case PMF_SMC_TRACE_READ_64:
+			/*
+			 * Copy the trace events of the CPU to the
+			 * buffer shared with the normal world.
+			 * x0 --> error code.
+			 * x1 --> number of events copied.
+			 * x2 --> number of events lost.
+			 */
+			rc = pmf_trace_read_smc(x1, &num_entries, &lost);
+			SMC_RET3(handle, rc, num_entries, lost);
+#endif
+
+#if LOCK_PROF
+		case PMF_SMC_GET_LOCK_STATS_64:
+			/*
+			 * Return error code and the requested
+			 * lock statistic to the caller.
+			 * x0 --> error code.
+			 * x1 --> statistic value.
+			 */
+			rc = lock_prof_get(x1, x2, &lock_value);
+			SMC_RET2(handle, rc, lock_value);
+#endif
+
+#if ENABLE_SPM
+		case PMF_SMC_GET_SPM_STATS_64:
+			/*
+			 * Return error code and the requested
+			 * Secure Partition statistic to the caller.
+			 * x0 --> error code.
+			 * x1 --> statistic value.
+			 */
+			rc = spm_stats_get(x1, &spm_value);
+			SMC_RET2(handle, rc, spm_value);
+#endif
+
 		default:
 			break;
 		}
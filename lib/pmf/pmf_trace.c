@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <arch_helpers.h>
+#include <assert.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <spinlock.h>
+#include <string.h>
+#include <utils_def.h>
+
+/*
+ * Number of entries of the trace buffer of each CPU. Once a buffer is full, the
+ * oldest entries that have not been read yet are overwritten and accounted for
+ * as lost.
+ */
+#ifndef PLAT_PMF_TRACE_ENTRIES
+#define PLAT_PMF_TRACE_ENTRIES		64
+#endif
+
+CASSERT(IS_POWER_OF_TWO(PLAT_PMF_TRACE_ENTRIES),
+	assert_pmf_trace_entries_power_of_two);
+
+#define PMF_TRACE_IDX_MASK		(PLAT_PMF_TRACE_ENTRIES - 1)
+
+/*
+ * Trace buffer of a CPU. Only the owning CPU writes into it, without locking.
+ * 'head' counts all the events recorded since boot.
+ */
+typedef struct pmf_trace_buf {
+	pmf_trace_entry_t entries[PLAT_PMF_TRACE_ENTRIES];
+	unsigned long long head;
+} __aligned(CACHE_WRITEBACK_GRANULE) pmf_trace_buf_t;
+
+/*
+ * Read state of a trace buffer. It is updated by the readers, possibly from
+ * another CPU, so it is kept out of the cache lines written by the owner of
+ * the buffer. 'tail' is the value of 'head' up to which events have been read.
+ */
+typedef struct pmf_trace_rd_state {
+	unsigned long long tail;
+	unsigned long long lost;
+} __aligned(CACHE_WRITEBACK_GRANULE) pmf_trace_rd_state_t;
+
+static pmf_trace_buf_t pmf_trace_bufs[PLATFORM_CORE_COUNT];
+static pmf_trace_rd_state_t pmf_trace_rd_states[PLATFORM_CORE_COUNT];
+
+/* Serialises the readers of the trace buffers */
+static spinlock_t pmf_trace_lock;
+LOCK_PROF_REGISTER(pmf_trace_lock, &pmf_trace_lock);
+
+/*
+ * This function records an event in the trace buffer of the calling CPU. If the
+ * data cache is disabled, the event is only recorded when the PMF_CACHE_MAINT
+ * flag is passed.
+ */
+void __pmf_trace_event(unsigned int event,
+		unsigned long long arg,
+		unsigned long long ts,
+		unsigned int flags)
+{
+	pmf_trace_buf_t *buf = &pmf_trace_bufs[plat_my_core_pos()];
+	pmf_trace_entry_t *entry;
+	unsigned long long head;
+	unsigned int is_cached;
+
+#ifdef AARCH32
+	is_cached = read_sctlr() & SCTLR_C_BIT;
+#else
+	is_cached = read_sctlr_el3() & SCTLR_C_BIT;
+#endif
+
+	/*
+	 * With the data cache disabled, the buffer is accessed in memory, which
+	 * may be older than dirty lines still held in the cache, and which such
+	 * lines would later overwrite. Clean and invalidate the lines before
+	 * they are accessed, or drop the event if the caller did not ask for
+	 * cache maintenance.
+	 */
+	if (is_cached == 0U) {
+		if ((flags & PMF_CACHE_MAINT) == 0U)
+			return;
+		flush_dcache_range((uintptr_t)&buf->head, sizeof(buf->head));
+	}
+
+	head = buf->head;
+	entry = &buf->entries[head & PMF_TRACE_IDX_MASK];
+
+	if (is_cached == 0U)
+		flush_dcache_range((uintptr_t)entry, sizeof(*entry));
+
+	entry->ts = ts;
+	entry->arg = arg;
+	entry->event = event;
+	entry->reserved = 0;
+
+	/* Publish the entry before the updated head */
+	if (flags & PMF_CACHE_MAINT)
+		flush_dcache_range((uintptr_t)entry, sizeof(*entry));
+	dmbishst();
+
+	buf->head = head + 1;
+	if (flags & PMF_CACHE_MAINT)
+		flush_dcache_range((uintptr_t)&buf->head, sizeof(buf->head));
+}
+
+/*
+ * This function copies the oldest unread events of the trace buffer of CPU
+ * `cpuid`, up to `max_entries`, to `dst`. It returns the number of events
+ * copied in `num_entries` and the number of events that were overwritten
+ * before they could be read since the previous call in `lost`.
+ */
+int pmf_trace_read(unsigned int cpuid,
+		pmf_trace_entry_t *dst,
+		unsigned int max_entries,
+		unsigned int *num_entries,
+		unsigned long long *lost)
+{
+	pmf_trace_buf_t *buf;
+	pmf_trace_rd_state_t *rd_state;
+	unsigned long long head, tail, overwritten;
+	unsigned int i, num;
+
+	assert((num_entries != NULL) && (lost != NULL));
+
+	if (cpuid >= PLATFORM_CORE_COUNT)
+		return -EINVAL;
+
+	assert((dst != NULL) || (max_entries == 0));
+
+	buf = &pmf_trace_bufs[cpuid];
+	rd_state = &pmf_trace_rd_states[cpuid];
+
+	spin_lock(&pmf_trace_lock);
+
+	head = buf->head;
+	dmbish();
+
+	/*
+	 * The owning CPU writes the entry at `head` before it publishes the
+	 * new head. That slot also holds the entry at `head - entries`, which
+	 * can therefore be torn: only the last `entries - 1` events are read.
+	 */
+	tail = rd_state->tail;
+	if ((head - tail) >= PLAT_PMF_TRACE_ENTRIES) {
+		rd_state->lost += head - tail - (PLAT_PMF_TRACE_ENTRIES - 1);
+		tail = head - (PLAT_PMF_TRACE_ENTRIES - 1);
+	}
+
+	num = MIN(head - tail, (unsigned long long)max_entries);
+	for (i = 0; i < num; i++)
+		dst[i] = buf->entries[(tail + i) & PMF_TRACE_IDX_MASK];
+
+	/*
+	 * The owning CPU may have wrapped around and overwritten some of the
+	 * entries while they were being copied, including the one it may be
+	 * writing at the new head. Discard them.
+	 */
+	dmbish();
+	head = buf->head;
+	if ((head - tail) >= PLAT_PMF_TRACE_ENTRIES) {
+		overwritten = MIN(head - tail - (PLAT_PMF_TRACE_ENTRIES - 1),
+				(unsigned long long)num);
+		memmove(dst, &dst[overwritten],
+			(num - overwritten) * sizeof(*dst));
+		rd_state->lost += overwritten;
+		num -= overwritten;
+		tail += overwritten;
+	}
+
+	rd_state->tail = tail + num;
+	*num_entries = num;
+	*lost = rd_state->lost;
+	rd_state->lost = 0;
+
+	spin_unlock(&pmf_trace_lock);
+
+	return 0;
+}
+
+/*
+ * This function copies the unread events of the CPU identified by `mpidr` to
+ * the buffer shared with the normal world, as many as fit in it.
+ */
+int pmf_trace_read_smc(u_register_t mpidr,
+		unsigned int *num_entries,
+		unsigned long long *lost)
+{
+#ifdef PLAT_PMF_TRACE_NS_BUF_BASE
+	pmf_trace_entry_t *dst = (pmf_trace_entry_t *)PLAT_PMF_TRACE_NS_BUF_BASE;
+	int cpuid = plat_core_pos_by_mpidr(mpidr);
+	int rc;
+
+	*num_entries = 0;
+	*lost = 0;
+
+	if (cpuid < 0)
+		return -EINVAL;
+
+	rc = pmf_trace_read(cpuid, dst,
+			PLAT_PMF_TRACE_NS_BUF_SIZE / sizeof(pmf_trace_entry_t),
+			num_entries, lost);
+
+	/* The normal world may read the buffer with its data cache disabled */
+	if ((rc == 0) && (*num_entries != 0))
+		flush_dcache_range((uintptr_t)dst,
+				*num_entries * sizeof(pmf_trace_entry_t));
+
+	return rc;
+#else
+	*num_entries = 0;
+	*lost = 0;
+
+	return -ENOTSUP;
+#endif
+}
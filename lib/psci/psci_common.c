@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -41,6 +41,50 @@ const spd_pm_ops_t *psci_spd_pm;
 static plat_local_state_t
 	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
 
+#if PSCI_LOCKLESS_SUSPEND
+/*
+ * Number of CPUs that request the RUN state for each non CPU power domain, i.e.
+ * that keep it running. A CPU updates the count of a power domain when its
+ * requested local power state for it changes from or to RUN, after the
+ * requested state. The counts are updated atomically, so a CPU can find out
+ * that it is not the last one to suspend in its level 1 power domain without
+ * taking the power domain locks. Each count has its own cache line.
+ *
+ * Such a cpu flushes its context and calls the platform suspend hook after it
+ * has left the count, without the locks. The lockless_suspend per-cpu flag is
+ * set meanwhile, and the cpu that brings the count to zero waits for the flags
+ * of the power domain to be cleared before it lets the platform power it down.
+ */
+typedef struct psci_run_count {
+	unsigned int count;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_run_count_t;
+
+static psci_run_count_t psci_run_counts[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+/******************************************************************************
+ * Wait until no cpu of the power domain 'parent_idx' is still suspending
+ * without the power domain locks. The caller holds the lock of the power
+ * domain and has found that no cpu keeps it running, so no other cpu can
+ * start suspending without the locks in the meantime.
+ *****************************************************************************/
+static void psci_wait_lockless_suspend(unsigned int parent_idx)
+{
+	unsigned int cpu_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	unsigned int end_idx = cpu_idx + psci_non_cpu_pd_nodes[parent_idx].ncpus;
+
+	for (; cpu_idx < end_idx; cpu_idx++) {
+		/*
+		 * The flag may be cleared with the data cache disabled, so
+		 * the stale line must be evicted before each read.
+		 */
+		do {
+			flush_cpu_data_by_index(cpu_idx,
+				psci_svc_cpu_data.lockless_suspend);
+		} while (psci_get_lockless_suspend_by_idx(cpu_idx) != 0U);
+	}
+}
+#endif
+
 
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
@@ -57,8 +101,12 @@ __section("tzfw_coherent_mem")
 
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+LOCK_PROF_REGISTER_ARRAY(psci_locks, psci_locks,
+			 PSCI_NUM_NON_CPU_PWR_DOMAINS, sizeof(psci_locks[0]));
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
+LOCK_PROF_REGISTER_ARRAY(psci_cpu_locks, &psci_cpu_pd_nodes[0].cpu_lock,
+			 PLATFORM_CORE_COUNT, sizeof(cpu_pd_node_t));
 
 /*******************************************************************************
  * Pointer to functions exported by the platform to complete power mgmt. ops
@@ -231,6 +279,35 @@ static plat_local_state_t *psci_get_req_local_pwr_states(unsigned int pwrlvl,
 	return &psci_req_local_pwr_states[pwrlvl - 1][cpu_idx];
 }
 
+/******************************************************************************
+ * Helper function to update the local power state requested by a cpu for its
+ * ancestor power domain 'parent_idx' at 'pwrlvl', along with the number of cpus
+ * that request the RUN state for that power domain.
+ *****************************************************************************/
+static void psci_update_req_local_pwr_state(unsigned int pwrlvl,
+					    unsigned int parent_idx,
+					    unsigned int cpu_idx,
+					    plat_local_state_t req_pwr_state)
+{
+#if PSCI_LOCKLESS_SUSPEND
+	unsigned int *count = &psci_run_counts[parent_idx].count;
+	int was_run = is_local_state_run(
+			*psci_get_req_local_pwr_states(pwrlvl, cpu_idx));
+
+	psci_set_req_local_pwr_state(pwrlvl, cpu_idx, req_pwr_state);
+
+	/* Publish the requested state along with the count */
+	if (was_run && !is_local_state_run(req_pwr_state)) {
+		assert(*count != 0);
+		(void)__atomic_sub_fetch(count, 1, __ATOMIC_ACQ_REL);
+	} else if (!was_run && is_local_state_run(req_pwr_state)) {
+		(void)__atomic_add_fetch(count, 1, __ATOMIC_ACQ_REL);
+	}
+#else
+	psci_set_req_local_pwr_state(pwrlvl, cpu_idx, req_pwr_state);
+#endif
+}
+
 /*
  * psci_non_cpu_pd_nodes can be placed either in normal memory or coherent
  * memory.
@@ -361,9 +438,10 @@ void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 		set_non_cpu_pd_node_local_state(parent_idx,
 				PSCI_LOCAL_STATE_RUN);
-		psci_set_req_local_pwr_state(lvl,
-					     cpu_idx,
-					     PSCI_LOCAL_STATE_RUN);
+		psci_update_req_local_pwr_state(lvl,
+						parent_idx,
+						cpu_idx,
+						PSCI_LOCAL_STATE_RUN);
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
 
@@ -409,8 +487,30 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 
 		/* First update the requested power state */
-		psci_set_req_local_pwr_state(lvl, cpu_idx,
-					     state_info->pwr_domain_state[lvl]);
+		psci_update_req_local_pwr_state(lvl, parent_idx, cpu_idx,
+					state_info->pwr_domain_state[lvl]);
+
+#if PSCI_LOCKLESS_SUSPEND
+		/*
+		 * The power domain keeps running as long as a cpu requests
+		 * RUN for it. This includes cpus that are trying to suspend
+		 * without locks and may have published their requested state
+		 * already, so the count must be checked first.
+		 */
+		if (__atomic_load_n(&psci_run_counts[parent_idx].count,
+				    __ATOMIC_ACQUIRE) != 0) {
+			state_info->pwr_domain_state[lvl] =
+				PSCI_LOCAL_STATE_RUN;
+			break;
+		}
+
+		/*
+		 * The cpus that have left the count without the locks may
+		 * still be flushing their context or in the platform suspend
+		 * hook. The power domain must not be powered down under them.
+		 */
+		psci_wait_lockless_suspend(parent_idx);
+#endif
 
 		/* Get the requested power states for this power level */
 		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
@@ -441,8 +541,9 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	 * set the target state as RUN.
 	 */
 	for (lvl = lvl + 1; lvl <= end_pwrlvl; lvl++) {
-		psci_set_req_local_pwr_state(lvl, cpu_idx,
-					     state_info->pwr_domain_state[lvl]);
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		psci_update_req_local_pwr_state(lvl, parent_idx, cpu_idx,
+					state_info->pwr_domain_state[lvl]);
 		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
 
 	}
@@ -451,6 +552,111 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_LOCKLESS_SUSPEND
+/******************************************************************************
+ * This function is a faster alternative to psci_do_state_coordination() for
+ * the suspend path, which does not require the power domain locks. It succeeds
+ * if another cpu of the level 1 power domain of the calling cpu requests RUN
+ * for it. The calling cpu cannot be the last one to leave any of its ancestor
+ * power domains then, so their target state is RUN and there is nothing to
+ * coordinate. It only records the local power states requested by the cpu up
+ * to 'end_pwrlvl' and updates 'state_info' with the target states.
+ *
+ * It returns 1 on success. Otherwise, it returns 0 without changing the
+ * state of the power domains, and the caller must acquire the power domain
+ * locks and call psci_do_state_coordination() instead. On success, the caller
+ * must call psci_lockless_suspend_done() once the platform suspend hook has
+ * returned.
+ *****************************************************************************/
+int psci_do_lockless_state_coordination(unsigned int end_pwrlvl,
+					psci_power_state_t *state_info)
+{
+	unsigned int lvl, cpu_idx = plat_my_core_pos();
+	unsigned int parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	unsigned int *count = &psci_run_counts[parent_idx].count;
+	unsigned int old_count;
+
+	assert((end_pwrlvl > PSCI_CPU_PWR_LVL) &&
+	       (end_pwrlvl <= PLAT_MAX_PWR_LVL));
+	assert(is_local_state_run(
+		*psci_get_req_local_pwr_states(PSCI_CPU_PWR_LVL + 1, cpu_idx)));
+
+	/*
+	 * Publish the requested state for the level 1 power domain before
+	 * leaving its count, so that the cpu that brings the count to zero
+	 * finds it when it coordinates the power domain. Until then, this cpu
+	 * is still counted, so the power domain stays running if another cpu
+	 * coordinates it in the meantime.
+	 */
+	psci_set_req_local_pwr_state(PSCI_CPU_PWR_LVL + 1, cpu_idx,
+			state_info->pwr_domain_state[PSCI_CPU_PWR_LVL + 1]);
+
+	/*
+	 * Let the cpu that brings the count to zero know that this cpu is not
+	 * done suspending yet. The flag is published by the release below.
+	 */
+	psci_set_lockless_suspend(1U);
+
+	old_count = __atomic_load_n(count, __ATOMIC_RELAXED);
+	do {
+		assert(old_count != 0);
+
+		/* Give up if this cpu may be the last one to suspend */
+		if (old_count == 1) {
+			psci_set_lockless_suspend(0U);
+			psci_set_req_local_pwr_state(PSCI_CPU_PWR_LVL + 1,
+					cpu_idx, PSCI_LOCAL_STATE_RUN);
+			return 0;
+		}
+	} while (!__atomic_compare_exchange_n(count, &old_count, old_count - 1,
+					      1, __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+
+	state_info->pwr_domain_state[PSCI_CPU_PWR_LVL + 1] =
+		PSCI_LOCAL_STATE_RUN;
+
+	/* The higher power domains keep running as well */
+	for (lvl = PSCI_CPU_PWR_LVL + 2; lvl <= end_pwrlvl; lvl++) {
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		psci_update_req_local_pwr_state(lvl, parent_idx, cpu_idx,
+					state_info->pwr_domain_state[lvl]);
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+	}
+
+	/*
+	 * Only the target state of the cpu changes. The local states of the
+	 * ancestor power domains are RUN already and are left alone, as they
+	 * may be updated concurrently by the cpu that coordinates them.
+	 */
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	return 1;
+}
+
+/******************************************************************************
+ * This function is called by a cpu that suspends without the power domain
+ * locks once the platform suspend hook has returned. It lets the cpu that
+ * coordinates the level 1 power domain power it down. For a power down state,
+ * the data cache is disabled, so the flag is written to main memory as for the
+ * affinity info state in the CPU_OFF path. Otherwise, the data cache is still
+ * enabled and the flag is cleaned to main memory after it has been written,
+ * which psci_wait_lockless_suspend() reads.
+ *****************************************************************************/
+void psci_lockless_suspend_done(unsigned int is_power_down_state)
+{
+	if (is_power_down_state != 0U) {
+		psci_flush_cpu_data(psci_svc_cpu_data.lockless_suspend);
+		psci_set_lockless_suspend(0U);
+		psci_dsbish();
+		psci_inv_cpu_data(psci_svc_cpu_data.lockless_suspend);
+	} else {
+		psci_set_lockless_suspend(0U);
+		psci_flush_cpu_data(psci_svc_cpu_data.lockless_suspend);
+	}
+}
+#endif
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -753,6 +959,11 @@ void psci_warmboot_entrypoint(void)
 		panic();
 	}
 
+#if CTX_LAZY_FPREGS
+	/* No security state's FP/SIMD registers survived the power down */
+	cm_fpregs_reset();
+#endif
+
 	/*
 	 * Get the maximum power domain level to traverse to after this cpu
 	 * has been physically powered up.
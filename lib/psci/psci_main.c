@@ -59,6 +59,11 @@ int psci_cpu_suspend(unsigned int power_state,
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 	plat_local_state_t cpu_pd_state;
 
+#if ENABLE_LOG_RING && defined(IMAGE_BL31)
+	/* Output the pending log messages while the CPU is about to idle */
+	tf_log_ring_flush();
+#endif
+
 	/* Validate the power_state parameter */
 	rc = psci_validate_power_state(power_state, &state_info);
 	if (rc != PSCI_E_SUCCESS) {
@@ -191,6 +196,10 @@ int psci_cpu_off(void)
 	int rc;
 	unsigned int target_pwrlvl = PLAT_MAX_PWR_LVL;
 
+#if ENABLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_flush();
+#endif
+
 	/*
 	 * Do what is needed to power off this CPU and possible higher power
 	 * levels if it able to do so. Upon success, enter the final wfi
@@ -115,6 +115,10 @@
 		get_cpu_data(psci_svc_cpu_data.local_state)
 #define psci_get_cpu_local_state_by_idx(idx) \
 		get_cpu_data_by_index(idx, psci_svc_cpu_data.local_state)
+#define psci_set_lockless_suspend(val) \
+		set_cpu_data(psci_svc_cpu_data.lockless_suspend, val)
+#define psci_get_lockless_suspend_by_idx(idx) \
+		get_cpu_data_by_index(idx, psci_svc_cpu_data.lockless_suspend)
 
 /*
  * Helper macros for the CPU level spinlocks
@@ -213,6 +217,11 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int node_index[]);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_LOCKLESS_SUSPEND
+int psci_do_lockless_state_coordination(unsigned int end_pwrlvl,
+					psci_power_state_t *state_info);
+void psci_lockless_suspend_done(unsigned int is_power_down_state);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
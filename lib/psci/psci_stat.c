@@ -1,13 +1,15 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <stdint.h>
 #include "psci_private.h"
 
 #ifndef PLAT_MAX_PWR_LVL_STATES
@@ -20,6 +22,43 @@ typedef struct psci_stat {
 	u_register_t count;
 } psci_stat_t;
 
+/*
+ * The stats of a CPU are updated by that CPU only. They are padded to a cache
+ * line so that CPUs updating their stats do not contend for the same lines.
+ */
+typedef struct psci_cpu_stat {
+	psci_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_cpu_stat_t;
+
+/*
+ * Layout of the snapshot written by psci_stat_snapshot(). The header is
+ * followed by one record for each CPU power domain, in the order of their
+ * core positions, and then one record for each non-CPU power domain.
+ */
+typedef struct psci_stat_snapshot_hdr {
+	uint32_t num_cpu_pds;
+	uint32_t num_non_cpu_pds;
+	uint32_t num_states;
+	uint32_t reserved;
+} psci_stat_snapshot_hdr_t;
+
+typedef struct psci_stat_snapshot_pd {
+	/* MPIDR of the CPU, or 0 for a non-CPU power domain */
+	uint64_t mpidr;
+	/* Power level of the domain */
+	uint32_t level;
+	/* Index of the parent non-CPU power domain record, or ~0 for a root */
+	uint32_t parent_idx;
+	struct {
+		uint64_t residency;
+		uint64_t count;
+	} stat[PLAT_MAX_PWR_LVL_STATES];
+} psci_stat_snapshot_pd_t;
+
+#define PSCI_STAT_SNAPSHOT_SIZE	(sizeof(psci_stat_snapshot_hdr_t) +	\
+				 (PSCI_NUM_PWR_DOMAINS *		\
+				  sizeof(psci_stat_snapshot_pd_t)))
+
 /*
  * Following is used to keep track of the last cpu
  * that goes to power down in non cpu power domains.
@@ -30,8 +69,7 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {-1};
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
+static psci_cpu_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT];
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
 
@@ -121,8 +159,8 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].residency += residency;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].count++;
 
 	/*
 	 * Check what power domains above CPU were off
@@ -206,7 +244,7 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat = psci_cpu_stat[target_idx].stat[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
@@ -237,3 +275,81 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+static void psci_stat_snapshot_pd(psci_stat_snapshot_pd_t *rec,
+				  u_register_t mpidr, unsigned int level,
+				  unsigned int parent_idx,
+				  const psci_stat_t *stat)
+{
+	unsigned int i;
+
+	rec->mpidr = mpidr;
+	rec->level = level;
+	rec->parent_idx = parent_idx;
+
+	for (i = 0; i < PLAT_MAX_PWR_LVL_STATES; i++) {
+		rec->stat[i].residency = stat[i].residency;
+		rec->stat[i].count = stat[i].count;
+	}
+}
+
+/*******************************************************************************
+ * This function writes the residency and count of every power state of every
+ * CPU and non-CPU power domain to the buffer at `buf`, which must lie within
+ * the Non-secure region described by PLAT_PSCI_STAT_NS_BUF_BASE and
+ * PLAT_PSCI_STAT_NS_BUF_SIZE. It replaces one PSCI_STAT_RESIDENCY and one
+ * PSCI_STAT_COUNT call per domain and state by a single call. The stats of
+ * each record are read while other CPUs may be updating theirs, so the
+ * snapshot as a whole is not atomic. The size of the snapshot is returned in
+ * `size_written`.
+ ******************************************************************************/
+int psci_stat_snapshot(uintptr_t buf, size_t size, size_t *size_written)
+{
+#ifdef PLAT_PSCI_STAT_NS_BUF_BASE
+	psci_stat_snapshot_hdr_t *hdr;
+	psci_stat_snapshot_pd_t *rec;
+	unsigned int i;
+
+	assert(size_written != NULL);
+	*size_written = 0;
+
+	if ((buf < PLAT_PSCI_STAT_NS_BUF_BASE) ||
+	    ((buf + size) < buf) ||
+	    ((buf + size) > (PLAT_PSCI_STAT_NS_BUF_BASE +
+			     PLAT_PSCI_STAT_NS_BUF_SIZE)) ||
+	    ((buf & (sizeof(uint64_t) - 1)) != 0))
+		return PSCI_E_INVALID_ADDRESS;
+
+	if (size < PSCI_STAT_SNAPSHOT_SIZE)
+		return PSCI_E_INVALID_PARAMS;
+
+	hdr = (psci_stat_snapshot_hdr_t *)buf;
+	hdr->num_cpu_pds = PLATFORM_CORE_COUNT;
+	hdr->num_non_cpu_pds = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+	hdr->num_states = PLAT_MAX_PWR_LVL_STATES;
+	hdr->reserved = 0;
+
+	rec = (psci_stat_snapshot_pd_t *)(hdr + 1);
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++, rec++)
+		psci_stat_snapshot_pd(rec, psci_cpu_pd_nodes[i].mpidr,
+				      PSCI_CPU_PWR_LVL,
+				      psci_cpu_pd_nodes[i].parent_node,
+				      psci_cpu_stat[i].stat);
+
+	for (i = 0; i < PSCI_NUM_NON_CPU_PWR_DOMAINS; i++, rec++)
+		psci_stat_snapshot_pd(rec, 0, psci_non_cpu_pd_nodes[i].level,
+				      psci_non_cpu_pd_nodes[i].parent_node,
+				      psci_non_cpu_stat[i]);
+
+	/* The caller may read the snapshot with its data cache disabled */
+	flush_dcache_range(buf, PSCI_STAT_SNAPSHOT_SIZE);
+
+	*size_written = PSCI_STAT_SNAPSHOT_SIZE;
+	return PSCI_E_SUCCESS;
+#else
+	assert(size_written != NULL);
+	*size_written = 0;
+
+	return PSCI_E_NOT_SUPPORTED;
+#endif
+}
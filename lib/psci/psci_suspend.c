@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -152,7 +152,7 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 			    psci_power_state_t *state_info,
 			    unsigned int is_power_down_state)
 {
-	int skip_wfi = 0;
+	int skip_wfi = 0, lockless = 0;
 	unsigned int idx = plat_my_core_pos();
 
 	/*
@@ -162,30 +162,48 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	assert(psci_plat_pm_ops->pwr_domain_suspend &&
 			psci_plat_pm_ops->pwr_domain_suspend_finish);
 
+#if PSCI_LOCKLESS_SUSPEND
 	/*
-	 * This function acquires the lock corresponding to each power
-	 * level so that by the time all locks are taken, the system topology
-	 * is snapshot and state management can be done safely.
+	 * If another cpu keeps the level 1 power domain of this cpu running,
+	 * the requested states can be recorded without taking the locks.
 	 */
-	psci_acquire_pwr_domain_locks(end_pwrlvl,
-				      idx);
+	if (end_pwrlvl > PSCI_CPU_PWR_LVL) {
+		if (read_isr_el1())
+			return;
 
-	/*
-	 * We check if there are any pending interrupts after the delay
-	 * introduced by lock contention to increase the chances of early
-	 * detection that a wake-up interrupt has fired.
-	 */
-	if (read_isr_el1()) {
-		skip_wfi = 1;
-		goto exit;
+		lockless = psci_do_lockless_state_coordination(end_pwrlvl,
+							       state_info);
 	}
 
-	/*
-	 * This function is passed the requested state info and
-	 * it returns the negotiated state info for each power level upto
-	 * the end level specified.
-	 */
-	psci_do_state_coordination(end_pwrlvl, state_info);
+#endif
+
+	if (!lockless) {
+		/*
+		 * This function acquires the lock corresponding to each power
+		 * level so that by the time all locks are taken, the system
+		 * topology is snapshot and state management can be done
+		 * safely.
+		 */
+		psci_acquire_pwr_domain_locks(end_pwrlvl,
+					      idx);
+
+		/*
+		 * We check if there are any pending interrupts after the delay
+		 * introduced by lock contention to increase the chances of
+		 * early detection that a wake-up interrupt has fired.
+		 */
+		if (read_isr_el1()) {
+			skip_wfi = 1;
+			goto exit;
+		}
+
+		/*
+		 * This function is passed the requested state info and
+		 * it returns the negotiated state info for each power level
+		 * upto the end level specified.
+		 */
+		psci_do_state_coordination(end_pwrlvl, state_info);
+	}
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -212,8 +230,13 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
-	psci_release_pwr_domain_locks(end_pwrlvl,
-				  idx);
+	if (!lockless)
+		psci_release_pwr_domain_locks(end_pwrlvl,
+					      idx);
+#if PSCI_LOCKLESS_SUSPEND
+	else
+		psci_lockless_suspend_done(is_power_down_state);
+#endif
 	if (skip_wfi)
 		return;
 
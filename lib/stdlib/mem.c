@@ -1,17 +1,74 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stddef.h> /* size_t */
+#include <stdint.h> /* uintptr_t */
+
+/*
+ * Unless USE_SMALL_MEM_FUNCS is set, the functions below process the aligned
+ * middle of the buffers one machine word at a time. Firmware is built with
+ * strict alignment checking enabled, so word accesses are only used when the
+ * buffers are mutually aligned, i.e. both can be aligned to a word boundary
+ * at the same time. Otherwise they fall back to the byte loops, which are
+ * also used on their own when USE_SMALL_MEM_FUNCS is set to save space.
+ */
+typedef uintptr_t __attribute__((__may_alias__)) word_t;
+
+#define WORD_SIZE		sizeof(word_t)
+#define WORD_MASK		(WORD_SIZE - 1)
+
+/* Number of words processed per iteration of the unrolled loops */
+#define WORDS_PER_LOOP		4
+#define BYTES_PER_LOOP		(WORDS_PER_LOOP * WORD_SIZE)
+
+/* 0x0101...01 and 0x8080...80 for a word */
+#define WORD_ONES		((word_t)-1 / 0xff)
+#define WORD_HIGHS		(WORD_ONES << 7)
+
+/* Non-zero if any byte of the word is zero */
+#define WORD_HAS_ZERO(w)	(((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+#define IS_WORD_ALIGNED(p)	(((uintptr_t)(p) & WORD_MASK) == 0)
+#define ARE_CO_ALIGNED(a, b)	((((uintptr_t)(a) ^ (uintptr_t)(b)) \
+				  & WORD_MASK) == 0)
 
 /*
  * Fill @count bytes of memory pointed to by @dst with @val
  */
 void *memset(void *dst, int val, size_t count)
 {
-	char *ptr = dst;
+	unsigned char *ptr = dst;
+
+#if !USE_SMALL_MEM_FUNCS
+	if (count >= WORD_SIZE) {
+		word_t *wptr;
+		word_t fill = WORD_ONES * (unsigned char)val;
+
+		while (!IS_WORD_ALIGNED(ptr)) {
+			*ptr++ = val;
+			count--;
+		}
+
+		wptr = (word_t *)ptr;
+		while (count >= BYTES_PER_LOOP) {
+			wptr[0] = fill;
+			wptr[1] = fill;
+			wptr[2] = fill;
+			wptr[3] = fill;
+			wptr += WORDS_PER_LOOP;
+			count -= BYTES_PER_LOOP;
+		}
+
+		while (count >= WORD_SIZE) {
+			*wptr++ = fill;
+			count -= WORD_SIZE;
+		}
+		ptr = (unsigned char *)wptr;
+	}
+#endif
 
 	while (count--)
 		*ptr++ = val;
@@ -29,6 +86,34 @@ int memcmp(const void *s1, const void *s2, size_t len)
 	unsigned char sc;
 	unsigned char dc;
 
+#if !USE_SMALL_MEM_FUNCS
+	if ((len >= WORD_SIZE) && ARE_CO_ALIGNED(s, d)) {
+		const word_t *ws, *wd;
+
+		while (!IS_WORD_ALIGNED(s)) {
+			sc = *s++;
+			dc = *d++;
+			len--;
+			if (sc - dc)
+				return (sc - dc);
+		}
+
+		/*
+		 * Skip the identical words. The byte loop below finds the
+		 * first difference in the word that differs, if any.
+		 */
+		ws = (const word_t *)s;
+		wd = (const word_t *)d;
+		while ((len >= WORD_SIZE) && (*ws == *wd)) {
+			ws++;
+			wd++;
+			len -= WORD_SIZE;
+		}
+		s = (const unsigned char *)ws;
+		d = (const unsigned char *)wd;
+	}
+#endif
+
 	while (len--) {
 		sc = *s++;
 		dc = *d++;
@@ -47,6 +132,37 @@ void *memcpy(void *dst, const void *src, size_t len)
 	const char *s = src;
 	char *d = dst;
 
+#if !USE_SMALL_MEM_FUNCS
+	if ((len >= WORD_SIZE) && ARE_CO_ALIGNED(s, d)) {
+		const word_t *ws;
+		word_t *wd;
+
+		while (!IS_WORD_ALIGNED(d)) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const word_t *)s;
+		wd = (word_t *)d;
+		while (len >= BYTES_PER_LOOP) {
+			wd[0] = ws[0];
+			wd[1] = ws[1];
+			wd[2] = ws[2];
+			wd[3] = ws[3];
+			ws += WORDS_PER_LOOP;
+			wd += WORDS_PER_LOOP;
+			len -= BYTES_PER_LOOP;
+		}
+
+		while (len >= WORD_SIZE) {
+			*wd++ = *ws++;
+			len -= WORD_SIZE;
+		}
+		s = (const char *)ws;
+		d = (char *)wd;
+	}
+#endif
+
 	while (len--)
 		*d++ = *s++;
 
@@ -74,6 +190,28 @@ void *memmove(void *dst, const void *src, size_t len)
 		const char *end = dst;
 		const char *s = (const char *)src + len;
 		char *d = (char *)dst + len;
+
+#if !USE_SMALL_MEM_FUNCS
+		if ((len >= WORD_SIZE) && ARE_CO_ALIGNED(s, d)) {
+			const word_t *ws;
+			word_t *wd;
+
+			while (!IS_WORD_ALIGNED(d)) {
+				*--d = *--s;
+				len--;
+			}
+
+			ws = (const word_t *)s;
+			wd = (word_t *)d;
+			while (len >= WORD_SIZE) {
+				*--wd = *--ws;
+				len -= WORD_SIZE;
+			}
+			s = (const char *)ws;
+			d = (char *)wd;
+		}
+#endif
+
 		while (d != end)
 			*--d = *--s;
 	}
@@ -85,10 +223,36 @@ void *memmove(void *dst, const void *src, size_t len)
  */
 void *memchr(const void *src, int c, size_t len)
 {
-	const char *s = src;
+	const unsigned char *s = src;
+	unsigned char uc = (unsigned char)c;
+
+#if !USE_SMALL_MEM_FUNCS
+	if (len >= WORD_SIZE) {
+		const word_t *ws;
+		word_t pattern = WORD_ONES * uc;
+
+		while (!IS_WORD_ALIGNED(s)) {
+			if (*s == uc)
+				return (void *) s;
+			s++;
+			len--;
+		}
+
+		/*
+		 * Skip the words that do not contain @c. The byte loop below
+		 * locates it in the word that does, if any.
+		 */
+		ws = (const word_t *)s;
+		while ((len >= WORD_SIZE) && !WORD_HAS_ZERO(*ws ^ pattern)) {
+			ws++;
+			len -= WORD_SIZE;
+		}
+		s = (const unsigned char *)ws;
+	}
+#endif
 
 	while (len--) {
-		if (*s == c)
+		if (*s == uc)
 			return (void *) s;
 		s++;
 	}
@@ -7,6 +7,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <bl_common.h>
 #include <common_def.h>
 #include <debug.h>
 #include <errno.h>
@@ -38,12 +39,30 @@
 # endif
 #endif
 
+#if PREGENERATE_XLAT_TABLES && defined(IMAGE_BL31) && !defined(XLAT_TABLES_GEN)
+/*
+ * The default translation context of BL31 and its translation tables are
+ * generated at build time by tools/xlat_tables_gen, from the memory map
+ * provided by the platform. XLAT_TABLES_GEN is defined when the library is
+ * built for that tool.
+ */
+#define XLAT_TABLES_PREGENERATED	1
+
+extern xlat_ctx_t tf_xlat_ctx;
+
+#if ENABLE_ASSERTIONS
+static void xlat_tables_check_pregenerated(void);
+#endif
+#else
+#define XLAT_TABLES_PREGENERATED	0
+
 /*
  * Allocate and initialise the default translation context for the BL image
  * currently executing.
  */
 REGISTER_XLAT_CONTEXT(tf, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
 		PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
+#endif
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 
@@ -55,31 +74,35 @@ REGISTER_XLAT_CONTEXT(tf, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
 
 /*
  * Returns the index of the array corresponding to the specified translation
- * table.
+ * table. The tables are stored in a single array, so the index is derived
+ * from the address of the table.
  */
 static int xlat_table_get_index(xlat_ctx_t *ctx, const uint64_t *table)
 {
-	for (unsigned int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables[i] == table)
-			return i;
+	uintptr_t offset = (uintptr_t)table - (uintptr_t)ctx->tables;
 
 	/*
 	 * Maybe we were asked to get the index of the base level table, which
 	 * should never happen.
 	 */
-	assert(0);
+	assert((offset % sizeof(*ctx->tables)) == 0);
+	assert((offset / sizeof(*ctx->tables)) < ctx->tables_num);
 
-	return -1;
+	return offset / sizeof(*ctx->tables);
 }
 
-/* Returns a pointer to an empty translation table. */
+/*
+ * Returns a pointer to an empty translation table, which must be referenced
+ * with xlat_table_inc_regions_count() straight away.
+ */
 static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	for (unsigned int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables_mapped_regions[i] == 0)
-			return ctx->tables[i];
+	if (ctx->tables_free_num == 0)
+		return NULL;
 
-	return NULL;
+	ctx->tables_free_num--;
+
+	return ctx->tables[ctx->tables_free[ctx->tables_free_num]];
 }
 
 /* Increments region count for a given table. */
@@ -88,10 +111,20 @@ static void xlat_table_inc_regions_count(xlat_ctx_t *ctx, const uint64_t *table)
 	ctx->tables_mapped_regions[xlat_table_get_index(ctx, table)]++;
 }
 
-/* Decrements region count for a given table. */
+/*
+ * Decrements region count for a given table. The table is freed when it
+ * isn't used by any region anymore.
+ */
 static void xlat_table_dec_regions_count(xlat_ctx_t *ctx, const uint64_t *table)
 {
-	ctx->tables_mapped_regions[xlat_table_get_index(ctx, table)]--;
+	int idx = xlat_table_get_index(ctx, table);
+
+	assert(ctx->tables_mapped_regions[idx] > 0);
+
+	if (--ctx->tables_mapped_regions[idx] == 0) {
+		assert(ctx->tables_free_num < ctx->tables_num);
+		ctx->tables_free[ctx->tables_free_num++] = idx;
+	}
 }
 
 /* Returns 0 if the speficied table isn't empty, otherwise 1. */
@@ -337,6 +370,11 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
+			/*
+			 * Contiguous groups never span several regions, so the
+			 * hint of the other entries of the group is removed
+			 * together with this one.
+			 */
 			table_base[table_idx] = INVALID_DESC;
 			xlat_arch_tlbi_va_regime(table_idx_va, ctx->xlat_regime);
 
@@ -506,6 +544,43 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	return ACTION_NONE;
 }
 
+/*
+ * Returns 1 if the contiguous group of entries of the given table that starts
+ * at 'group_idx' can be mapped with the contiguous hint set, 0 otherwise. The
+ * whole group must be covered by the region and written by it with block or
+ * page descriptors, and its output address must be aligned to the size of the
+ * group. As the entries are still invalid, the hint is set when they are
+ * written for the first time and break-before-make isn't needed.
+ */
+static int xlat_tables_map_contig_allowed(const mmap_region_t *mm,
+		const uint64_t *table_base, const uintptr_t table_base_va,
+		const int table_entries, const int group_idx,
+		const unsigned int level)
+{
+	uintptr_t group_va = table_base_va +
+			     ((uintptr_t)group_idx << XLAT_ADDR_SHIFT(level));
+	uintptr_t idx_va = group_va;
+	unsigned long long group_pa = mm->base_pa + group_va - mm->base_va;
+
+	if ((mm->attr & MT_NO_CONTIG_HINT) ||
+	    ((group_idx + XLAT_CONT_ENTRIES) > table_entries) ||
+	    (group_va < mm->base_va) ||
+	    ((group_va + XLAT_CONT_MASK(level)) > (mm->base_va + mm->size - 1)) ||
+	    ((group_pa & XLAT_CONT_MASK(level)) != 0))
+		return 0;
+
+	for (int i = group_idx; i < group_idx + XLAT_CONT_ENTRIES; i++) {
+		if (xlat_tables_map_region_action(mm, table_base[i] & DESC_MASK,
+				mm->base_pa + idx_va - mm->base_va, idx_va,
+				level) != ACTION_WRITE_BLOCK_ENTRY)
+			return 0;
+
+		idx_va += XLAT_BLOCK_SIZE(level);
+	}
+
+	return 1;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -530,6 +605,9 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 	int table_idx;
 
+	/* Contiguous hint of the group that contains the current entry */
+	int contig = 0;
+
 	if (mm->base_va > table_base_va) {
 		/* Find the first index of the table affected by the region. */
 		table_idx_va = mm->base_va & ~XLAT_BLOCK_MASK(level);
@@ -555,6 +633,16 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
 
+		/*
+		 * A group that doesn't start in the region can't be mapped
+		 * with the contiguous hint, so it is enough to decide it at the
+		 * first entry of each group.
+		 */
+		if ((table_idx % XLAT_CONT_ENTRIES) == 0)
+			contig = xlat_tables_map_contig_allowed(mm, table_base,
+					table_base_va, table_entries,
+					table_idx, level);
+
 		action_t action = xlat_tables_map_region_action(mm,
 			desc & DESC_MASK, table_idx_pa, table_idx_va, level);
 
@@ -562,6 +650,8 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 			table_base[table_idx] =
 				xlat_desc(ctx, mm->attr, table_idx_pa, level);
+			if (contig)
+				table_base[table_idx] |= UPPER_ATTRS(CONT_HINT);
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 
@@ -1079,6 +1169,9 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 	}
 
 	tf_printf(LOWER_ATTRS(NS) & desc ? "-NS" : "-S");
+
+	if (UPPER_ATTRS(CONT_HINT) & desc)
+		tf_printf("-CONT");
 }
 
 static const char * const level_spacers[] = {
@@ -1206,11 +1299,7 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 
 	int used_page_tables;
 #if PLAT_XLAT_TABLES_DYNAMIC
-	used_page_tables = 0;
-	for (unsigned int i = 0; i < ctx->tables_num; ++i) {
-		if (ctx->tables_mapped_regions[i] != 0)
-			++used_page_tables;
-	}
+	used_page_tables = ctx->tables_num - ctx->tables_free_num;
 #else
 	used_page_tables = ctx->next_table;
 #endif
@@ -1239,9 +1328,18 @@ void init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	for (unsigned int i = 0; i < ctx->base_table_entries; i++)
 		ctx->base_table[i] = INVALID_DESC;
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+	/*
+	 * All the tables are free. They are stacked in reverse order so that
+	 * the first one is allocated first.
+	 */
+	ctx->tables_free_num = ctx->tables_num;
+#endif
+
 	for (unsigned int j = 0; j < ctx->tables_num; j++) {
 #if PLAT_XLAT_TABLES_DYNAMIC
 		ctx->tables_mapped_regions[j] = 0;
+		ctx->tables_free[j] = ctx->tables_num - 1 - j;
 #endif
 		for (unsigned int i = 0; i < XLAT_TABLE_ENTRIES; i++)
 			ctx->tables[j][i] = INVALID_DESC;
@@ -1272,7 +1370,22 @@ void init_xlat_tables_ctx(xlat_ctx_t *ctx)
 
 void init_xlat_tables(void)
 {
+#if XLAT_TABLES_PREGENERATED
+	/*
+	 * The translation tables are ready to use. Only check that the CPU
+	 * supports the physical address space they were generated for, and
+	 * that they were generated for the layout BL31 was linked with.
+	 */
+	assert(tf_xlat_ctx.initialized);
+	assert(tf_xlat_ctx.pa_max_address <= xlat_arch_get_max_supported_pa());
+#if ENABLE_ASSERTIONS
+	xlat_tables_check_pregenerated();
+#endif
+
+	xlat_tables_print(&tf_xlat_ctx);
+#else
 	init_xlat_tables_ctx(&tf_xlat_ctx);
+#endif
 }
 
 /*
@@ -1410,6 +1523,52 @@ static uint64_t *find_xlat_table_entry(uintptr_t virtual_addr,
 }
 
 
+/*
+ * Returns the attributes of the memory region described by the given block or
+ * page descriptor.
+ */
+static mmap_attr_t xlat_desc_get_attr(const xlat_ctx_t *ctx, uint64_t desc)
+{
+	mmap_attr_t attr = 0;
+
+	int attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+
+	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
+		attr |= MT_MEMORY;
+	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
+		attr |= MT_NON_CACHEABLE;
+	} else {
+		assert(attr_index == ATTR_DEVICE_INDEX);
+		attr |= MT_DEVICE;
+	}
+
+	int ap2_bit = (desc >> AP2_SHIFT) & 1;
+
+	if (ap2_bit == AP2_RW)
+		attr |= MT_RW;
+
+	if (ctx->xlat_regime == EL1_EL0_REGIME) {
+		int ap1_bit = (desc >> AP1_SHIFT) & 1;
+		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
+			attr |= MT_USER;
+	}
+
+	int ns_bit = (desc >> NS_SHIFT) & 1;
+
+	if (ns_bit == 1)
+		attr |= MT_NS;
+
+	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
+
+	if ((desc & xn_mask) == xn_mask) {
+		attr |= MT_EXECUTE_NEVER;
+	} else {
+		assert((desc & xn_mask) == 0);
+	}
+
+	return attr;
+}
+
 static int get_mem_attributes_internal(const xlat_ctx_t *ctx, uintptr_t base_va,
 		mmap_attr_t *attributes, uint64_t **table_entry,
 		unsigned long long *addr_pa, int *table_level)
@@ -1460,68 +1619,497 @@ static int get_mem_attributes_internal(const xlat_ctx_t *ctx, uintptr_t base_va,
 #endif /* LOG_LEVEL >= LOG_LEVEL_VERBOSE */
 
 	assert(attributes != NULL);
-	*attributes = 0;
+	*attributes = xlat_desc_get_attr(ctx, desc);
 
-	int attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
+	return 0;
+}
 
-	if (attr_index == ATTR_IWBWA_OWBWA_NTR_INDEX) {
-		*attributes |= MT_MEMORY;
-	} else if (attr_index == ATTR_NON_CACHEABLE_INDEX) {
-		*attributes |= MT_NON_CACHEABLE;
-	} else {
-		assert(attr_index == ATTR_DEVICE_INDEX);
-		*attributes |= MT_DEVICE;
+
+int get_mem_attributes(const xlat_ctx_t *ctx, uintptr_t base_va,
+		mmap_attr_t *attributes)
+{
+	return get_mem_attributes_internal(ctx, base_va, attributes,
+					   NULL, NULL, NULL);
+}
+
+#if XLAT_TABLES_PREGENERATED && ENABLE_ASSERTIONS
+/*
+ * Checks that the pregenerated translation tables flat-map the region
+ * [base, end) with the attributes 'attr'.
+ */
+static void xlat_tables_check_pregenerated_region(uintptr_t base,
+						  uintptr_t end,
+						  mmap_attr_t attr)
+{
+	uintptr_t va = base;
+
+	while (va < end) {
+		mmap_attr_t va_attr;
+		unsigned long long pa;
+		int level;
+		int rc;
+
+		rc = get_mem_attributes_internal(&tf_xlat_ctx, va, &va_attr,
+						 NULL, &pa, &level);
+		assert(rc == 0);
+
+		va &= ~XLAT_BLOCK_MASK(level);
+		assert(pa == va);
+		assert(va_attr == attr);
+
+		va += XLAT_BLOCK_SIZE(level);
 	}
+}
 
-	int ap2_bit = (desc >> AP2_SHIFT) & 1;
+/*
+ * Checks that the BL31 image, from __TEXT_START__ to __RW_END__, is mapped
+ * with the same attributes as if the tables were built at cold boot. The
+ * tables are generated for the fixed end of the code and of the read-only
+ * data given by the platform, not for the image that was actually linked.
+ */
+static void xlat_tables_check_pregenerated(void)
+{
+	xlat_tables_check_pregenerated_region(BL_CODE_BASE, BL_CODE_END,
+					      MT_CODE | MT_SECURE);
+	xlat_tables_check_pregenerated_region(BL_RO_DATA_BASE, BL_RO_DATA_END,
+					      MT_RO_DATA | MT_SECURE);
+	xlat_tables_check_pregenerated_region((uintptr_t)&__RW_START__,
+					      (uintptr_t)&__RW_END__,
+					      MT_RW_DATA | MT_SECURE);
+}
+#endif /* XLAT_TABLES_PREGENERATED && ENABLE_ASSERTIONS */
 
-	if (ap2_bit == AP2_RW)
-		*attributes |= MT_RW;
 
-	if (ctx->xlat_regime == EL1_EL0_REGIME) {
-		int ap1_bit = (desc >> AP1_SHIFT) & 1;
-		if (ap1_bit == AP1_ACCESS_UNPRIVILEGED)
-			*attributes |= MT_USER;
+/*
+ * Number of pages above which change_mem_attributes() invalidates all the TLB
+ * entries of the translation regime at once, rather than one entry at a time.
+ */
+#define XLAT_TLBI_VA_MAX_PAGES		64
+
+/* Bit that is clear in the invalid descriptors, whatever their other bits */
+#define XLAT_DESC_VALID_BIT		ULL(0x1)
+
+/*
+ * Returns the block or page descriptor that results from applying the
+ * attributes 'attr' that change_mem_attributes() can change to the given
+ * descriptor at 'level'. The valid bit of 'desc' is ignored.
+ */
+static uint64_t xlat_desc_change_attr(const xlat_ctx_t *ctx, uint64_t desc,
+				      mmap_attr_t attr, int level)
+{
+	mmap_attr_t new_attr = xlat_desc_get_attr(ctx, desc);
+
+	/*
+	 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
+	 * MT_USER/MT_PRIVILEGED are taken into account. Any other
+	 * information is ignored.
+	 */
+	new_attr &= ~(MT_RW|MT_EXECUTE_NEVER|MT_USER);
+	new_attr |= attr & (MT_RW|MT_EXECUTE_NEVER|MT_USER);
+
+	return xlat_desc(ctx, new_attr, desc & TABLE_ADDR_MASK, level);
+}
+
+/*
+ * Returns the index of the first entry of a translation table mapping
+ * 'table_base_va' at 'level' that is affected by a range starting at 'base_va',
+ * and the start VA of this entry in 'idx_va'.
+ */
+static int xlat_table_first_idx(uintptr_t table_base_va, unsigned int level,
+				uintptr_t base_va, uintptr_t *idx_va)
+{
+	if (base_va <= table_base_va) {
+		*idx_va = table_base_va;
+		return 0;
 	}
 
-	int ns_bit = (desc >> NS_SHIFT) & 1;
+	*idx_va = base_va & ~XLAT_BLOCK_MASK(level);
 
-	if (ns_bit == 1)
-		*attributes |= MT_NS;
+	return (*idx_va - table_base_va) >> XLAT_ADDR_SHIFT(level);
+}
 
-	uint64_t xn_mask = xlat_arch_regime_get_xn_desc(ctx->xlat_regime);
+/*
+ * Returns the number of translation tables needed to split the block at
+ * 'block_va' and 'level' so that the range [base_va, end_va], which covers it
+ * partially, is mapped by entries of its own. The ends of the range are page
+ * aligned, so only the blocks containing them need to be split further.
+ */
+static int xlat_split_tables_needed(uintptr_t block_va, unsigned int level,
+				    uintptr_t base_va, uintptr_t end_va)
+{
+	uintptr_t block_end_va = block_va + XLAT_BLOCK_SIZE(level) - 1;
+	uintptr_t first_va = 0, last_va;
+	unsigned int child_level = level + 1;
+	int count = 1;
+
+	assert(child_level <= XLAT_TABLE_LEVEL_MAX);
+
+	if ((base_va > block_va) &&
+	    ((base_va & XLAT_BLOCK_MASK(child_level)) != 0)) {
+		first_va = base_va & ~XLAT_BLOCK_MASK(child_level);
+		count += xlat_split_tables_needed(first_va, child_level,
+						  base_va, end_va);
+	}
 
-	if ((desc & xn_mask) == xn_mask) {
-		*attributes |= MT_EXECUTE_NEVER;
-	} else {
-		assert((desc & xn_mask) == 0);
+	if ((end_va < block_end_va) &&
+	    (((end_va + 1) & XLAT_BLOCK_MASK(child_level)) != 0)) {
+		last_va = end_va & ~XLAT_BLOCK_MASK(child_level);
+		if (last_va != first_va)
+			count += xlat_split_tables_needed(last_va, child_level,
+							  base_va, end_va);
+	}
+
+	return count;
+}
+
+/* Returns the number of translation tables that are still available. */
+static int xlat_tables_free_count(const xlat_ctx_t *ctx)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	return ctx->tables_free_num;
+#else
+	return ctx->tables_num - ctx->next_table;
+#endif
+}
+
+/*
+ * Recursive function that checks that the range [base_va, end_va] is mapped
+ * by the given translation table and that its attributes can be changed to
+ * 'attr'. The number of tables needed to split the blocks that the range
+ * covers partially is added to '*tables_needed'.
+ */
+static int xlat_change_mem_attr_check(const xlat_ctx_t *ctx,
+				      const uint64_t *table,
+				      uintptr_t table_base_va,
+				      int table_entries,
+				      unsigned int level,
+				      uintptr_t base_va,
+				      uintptr_t end_va,
+				      mmap_attr_t attr,
+				      int *tables_needed)
+{
+	uintptr_t idx_va, idx_end_va;
+	uint64_t desc;
+	int idx, rc;
+
+	idx = xlat_table_first_idx(table_base_va, level, base_va, &idx_va);
+
+	for (; idx < table_entries; idx++, idx_va += XLAT_BLOCK_SIZE(level)) {
+		idx_end_va = idx_va + XLAT_BLOCK_SIZE(level) - 1;
+		desc = table[idx];
+
+		if ((desc & DESC_MASK) == INVALID_DESC) {
+			WARN("Address %p is not mapped.\n",
+			     (void *)MAX(idx_va, base_va));
+			return -EINVAL;
+		}
+
+		/*
+		 * There can't be table entries at the final lookup level.
+		 */
+		assert((level < XLAT_TABLE_LEVEL_MAX) ||
+		       ((desc & DESC_MASK) == PAGE_DESC));
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			rc = xlat_change_mem_attr_check(ctx,
+					(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+					idx_va, XLAT_TABLE_ENTRIES, level + 1,
+					base_va, end_va, attr, tables_needed);
+			if (rc != 0)
+				return rc;
+		} else {
+			/*
+			 * If the region type is device, it shouldn't be
+			 * executable.
+			 */
+			int attr_index = (desc >> ATTR_INDEX_SHIFT) &
+					 ATTR_INDEX_MASK;
+			if ((attr_index == ATTR_DEVICE_INDEX) &&
+			    ((attr & MT_EXECUTE_NEVER) == 0)) {
+				WARN("Setting device memory as executable at address %p.",
+				     (void *)MAX(idx_va, base_va));
+				return -EINVAL;
+			}
+
+			/* Blocks covered partially must be split */
+			if ((idx_va < base_va) || (idx_end_va > end_va))
+				*tables_needed += xlat_split_tables_needed(
+					idx_va, level, base_va, end_va);
+		}
+
+		if (idx_end_va >= end_va)
+			break;
 	}
 
 	return 0;
 }
 
+/*
+ * Returns a new translation table mapping the block described by 'desc' at
+ * 'block_va' and 'level' at the next level, the part of the block covered by
+ * the range [base_va, end_va] with the attributes changed to 'attr' and the
+ * rest of it unchanged. The table is not referenced by any other table yet, so
+ * it can be written without break-before-make.
+ */
+static uint64_t *xlat_split_block(xlat_ctx_t *ctx, uint64_t desc,
+				  uintptr_t block_va, unsigned int level,
+				  uintptr_t base_va, uintptr_t end_va,
+				  mmap_attr_t attr)
+{
+	unsigned int child_level = level + 1;
+	uintptr_t idx_va = block_va, idx_end_va;
+	unsigned long long idx_pa = desc & TABLE_ADDR_MASK;
+	uint64_t child_desc, *subtable, *child_table;
 
-int get_mem_attributes(const xlat_ctx_t *ctx, uintptr_t base_va,
-		mmap_attr_t *attributes)
+	subtable = xlat_table_get_empty(ctx);
+	assert(subtable != NULL);
+#if PLAT_XLAT_TABLES_DYNAMIC
+	/* The table belongs to the region that mapped the block */
+	xlat_table_inc_regions_count(ctx, subtable);
+#endif
+
+	/*
+	 * The entries of the table inherit the attributes of the block, but not
+	 * its contiguous hint, as the entries around the range get different
+	 * attributes.
+	 */
+	child_desc = desc & ~(TABLE_ADDR_MASK | DESC_MASK |
+			      UPPER_ATTRS(CONT_HINT));
+	child_desc |= (child_level == XLAT_TABLE_LEVEL_MAX) ?
+		      PAGE_DESC : BLOCK_DESC;
+
+	for (int i = 0; i < XLAT_TABLE_ENTRIES; i++) {
+		idx_end_va = idx_va + XLAT_BLOCK_SIZE(child_level) - 1;
+
+		if ((idx_end_va < base_va) || (idx_va > end_va)) {
+			subtable[i] = child_desc | idx_pa;
+		} else if ((idx_va >= base_va) && (idx_end_va <= end_va)) {
+			subtable[i] = xlat_desc_change_attr(ctx,
+					child_desc | idx_pa, attr,
+					child_level);
+		} else {
+			child_table = xlat_split_block(ctx,
+					child_desc | idx_pa, idx_va,
+					child_level, base_va, end_va, attr);
+			subtable[i] = TABLE_DESC | (uintptr_t)child_table;
+		}
+
+		idx_va += XLAT_BLOCK_SIZE(child_level);
+		idx_pa += XLAT_BLOCK_SIZE(child_level);
+	}
+
+	return subtable;
+}
+
+/*
+ * Returns the index of the first entry of the contiguous group that contains
+ * the entry 'idx' of a translation table, and its start VA in 'group_va'.
+ */
+static int xlat_contig_group_first_idx(uintptr_t table_base_va,
+				       unsigned int level, int idx,
+				       uintptr_t *group_va)
 {
-	return get_mem_attributes_internal(ctx, base_va, attributes,
-					   NULL, NULL, NULL);
+	int group_idx = idx & ~(XLAT_CONT_ENTRIES - 1);
+
+	*group_va = table_base_va +
+		    ((uintptr_t)group_idx << XLAT_ADDR_SHIFT(level));
+
+	return group_idx;
+}
+
+/*
+ * Breaks the entries of the contiguous group that contains the entry 'idx' of
+ * the given translation table that are outside of the range [base_va, end_va].
+ * If 'tlbi_va' is set, their TLB entries are invalidated, but the invalidation
+ * isn't waited for.
+ */
+static void xlat_contig_group_break(const xlat_ctx_t *ctx, uint64_t *table,
+				    uintptr_t table_base_va, int table_entries,
+				    unsigned int level, int idx,
+				    uintptr_t base_va, uintptr_t end_va,
+				    int tlbi_va)
+{
+	uintptr_t va;
+	int i = xlat_contig_group_first_idx(table_base_va, level, idx, &va);
+	int group_end = i + XLAT_CONT_ENTRIES;
+
+	assert(group_end <= table_entries);
+
+	for (; i < group_end; i++, va += XLAT_BLOCK_SIZE(level)) {
+		if ((va <= end_va) && ((va + XLAT_BLOCK_MASK(level)) >= base_va))
+			continue;
+
+		assert((table[i] & XLAT_DESC_VALID_BIT) != 0);
+		table[i] &= ~XLAT_DESC_VALID_BIT;
+
+		if (tlbi_va)
+			xlat_arch_tlbi_va_regime(va, ctx->xlat_regime);
+	}
+}
+
+/*
+ * Rewrites the entries of the contiguous group that contains the entry 'idx'
+ * of the given translation table that xlat_contig_group_break() broke, with
+ * the same attributes but without the contiguous hint. The invalid entries
+ * are all zero, so the broken ones are the entries that have other bits set.
+ */
+static void xlat_contig_group_make(uint64_t *table, uintptr_t table_base_va,
+				   int table_entries, unsigned int level,
+				   int idx, uintptr_t base_va, uintptr_t end_va)
+{
+	uintptr_t va;
+	int i = xlat_contig_group_first_idx(table_base_va, level, idx, &va);
+	int group_end = MIN(i + (int)XLAT_CONT_ENTRIES, table_entries);
+
+	for (; i < group_end; i++, va += XLAT_BLOCK_SIZE(level)) {
+		if ((va <= end_va) && ((va + XLAT_BLOCK_MASK(level)) >= base_va))
+			continue;
+
+		if ((table[i] != INVALID_DESC) &&
+		    ((table[i] & XLAT_DESC_VALID_BIT) == 0))
+			table[i] = (table[i] & ~UPPER_ATTRS(CONT_HINT)) |
+				   XLAT_DESC_VALID_BIT;
+	}
+}
+
+/*
+ * Recursive function that breaks the entries of the given translation table
+ * that map the range [base_va, end_va] by clearing their valid bit, so that
+ * they can all be rewritten once the TLBs have been invalidated. The other
+ * bits of the entries are kept for xlat_change_mem_attr_make(). Blocks that
+ * the range covers partially are replaced by new tables, which are referenced
+ * by the broken entries. If 'tlbi_va' is set, the TLB entries of each broken
+ * entry are invalidated, but the invalidation isn't waited for.
+ */
+static void xlat_change_mem_attr_break(xlat_ctx_t *ctx,
+				       uint64_t *table,
+				       uintptr_t table_base_va,
+				       int table_entries,
+				       unsigned int level,
+				       uintptr_t base_va,
+				       uintptr_t end_va,
+				       mmap_attr_t attr,
+				       int tlbi_va)
+{
+	uintptr_t idx_va, idx_end_va;
+	uint64_t desc, *subtable;
+	int idx, first_idx;
+
+	idx = xlat_table_first_idx(table_base_va, level, base_va, &idx_va);
+	first_idx = idx;
+
+	for (; idx < table_entries; idx++, idx_va += XLAT_BLOCK_SIZE(level)) {
+		idx_end_va = idx_va + XLAT_BLOCK_SIZE(level) - 1;
+		desc = table[idx];
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			xlat_change_mem_attr_break(ctx,
+					(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+					idx_va, XLAT_TABLE_ENTRIES, level + 1,
+					base_va, end_va, attr, tlbi_va);
+		} else {
+			/*
+			 * All the entries of a contiguous group must have the
+			 * same attributes, so the hint is removed from the
+			 * whole group. The entries of the group outside of the
+			 * range are broken too, and xlat_change_mem_attr_make()
+			 * rewrites them unchanged, without the hint. Only the
+			 * groups at the ends of the range have such entries.
+			 */
+			if (((desc & UPPER_ATTRS(CONT_HINT)) != 0) &&
+			    ((idx == first_idx) ||
+			     ((idx % XLAT_CONT_ENTRIES) == 0)))
+				xlat_contig_group_break(ctx, table,
+						table_base_va, table_entries,
+						level, idx, base_va, end_va,
+						tlbi_va);
+
+			if ((idx_va < base_va) || (idx_end_va > end_va)) {
+				subtable = xlat_split_block(ctx, desc, idx_va,
+						level, base_va, end_va, attr);
+				desc = TABLE_DESC | (uintptr_t)subtable;
+			}
+
+			table[idx] = desc & ~XLAT_DESC_VALID_BIT;
+
+			if (tlbi_va)
+				xlat_arch_tlbi_va_regime(idx_va,
+							 ctx->xlat_regime);
+		}
+
+		if (idx_end_va >= end_va)
+			break;
+	}
 }
 
+/*
+ * Recursive function that rewrites the entries broken by
+ * xlat_change_mem_attr_break() in the given translation table, with the
+ * attributes changed to 'attr', or to point to the tables that replace the
+ * blocks split by it.
+ */
+static void xlat_change_mem_attr_make(const xlat_ctx_t *ctx,
+				      uint64_t *table,
+				      uintptr_t table_base_va,
+				      int table_entries,
+				      unsigned int level,
+				      uintptr_t base_va,
+				      uintptr_t end_va,
+				      mmap_attr_t attr)
+{
+	uintptr_t idx_va, idx_end_va;
+	uint64_t desc;
+	int idx;
+
+	idx = xlat_table_first_idx(table_base_va, level, base_va, &idx_va);
+
+	/* Entries before the range broken with a contiguous group */
+	xlat_contig_group_make(table, table_base_va, table_entries, level, idx,
+			       base_va, end_va);
+
+	for (; idx < table_entries; idx++, idx_va += XLAT_BLOCK_SIZE(level)) {
+		idx_end_va = idx_va + XLAT_BLOCK_SIZE(level) - 1;
+		desc = table[idx];
+
+		if ((desc & XLAT_DESC_VALID_BIT) != 0) {
+			/* Only the leaf entries and split blocks were broken */
+			assert((level < XLAT_TABLE_LEVEL_MAX) &&
+			       ((desc & DESC_MASK) == TABLE_DESC));
+			xlat_change_mem_attr_make(ctx,
+					(uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+					idx_va, XLAT_TABLE_ENTRIES, level + 1,
+					base_va, end_va, attr);
+		} else if ((level < XLAT_TABLE_LEVEL_MAX) &&
+			   (((desc | XLAT_DESC_VALID_BIT) & DESC_MASK) ==
+			    TABLE_DESC)) {
+			/* Split block, its table is complete already */
+			table[idx] = desc | XLAT_DESC_VALID_BIT;
+		} else {
+			table[idx] = xlat_desc_change_attr(ctx, desc, attr,
+							   level);
+		}
+
+		if (idx_end_va >= end_va) {
+			/* Entries after the range broken with a group */
+			xlat_contig_group_make(table, table_base_va,
+					       table_entries, level, idx,
+					       base_va, end_va);
+			break;
+		}
+	}
+}
 
 int change_mem_attributes(xlat_ctx_t *ctx,
 			uintptr_t base_va,
 			size_t size,
 			mmap_attr_t attr)
 {
-	/* Note: This implementation isn't optimized. */
-
 	assert(ctx != NULL);
 	assert(ctx->initialized);
 
-	unsigned long long virt_addr_space_size =
-		(unsigned long long)ctx->va_max_address + 1;
-	assert(virt_addr_space_size > 0);
+	assert(((unsigned long long)ctx->va_max_address + 1) > 0);
 
 	if (!IS_PAGE_ALIGNED(base_va)) {
 		WARN("%s: Address %p is not aligned on a page boundary.\n",
@@ -1546,114 +2134,60 @@ int change_mem_attributes(xlat_ctx_t *ctx,
 		return -EINVAL;
 	}
 
-	int pages_count = size / PAGE_SIZE;
+	uintptr_t end_va = base_va + size - 1;
 
-	VERBOSE("Changing memory attributes of %i pages starting from address %p...\n",
-		pages_count, (void *)base_va);
+	if ((end_va < base_va) || (end_va > ctx->va_max_address)) {
+		WARN("Address %p is not mapped.\n", (void *)base_va);
+		return -EINVAL;
+	}
 
-	uintptr_t base_va_original = base_va;
+	VERBOSE("Changing memory attributes of %zu pages starting from address %p...\n",
+		size / PAGE_SIZE, (void *)base_va);
 
 	/*
-	 * Sanity checks.
+	 * Sanity checks, and count the tables needed to split the blocks
+	 * covered partially, so that nothing is changed if they are missing.
 	 */
-	for (int i = 0; i < pages_count; ++i) {
-		uint64_t *entry;
-		uint64_t desc;
-		int level;
-
-		entry = find_xlat_table_entry(base_va,
-					      ctx->base_table,
-					      ctx->base_table_entries,
-					      virt_addr_space_size,
-					      &level);
-		if (entry == NULL) {
-			WARN("Address %p is not mapped.\n", (void *)base_va);
-			return -EINVAL;
-		}
-
-		desc = *entry;
-
-		/*
-		 * Check that all the required pages are mapped at page
-		 * granularity.
-		 */
-		if (((desc & DESC_MASK) != PAGE_DESC) ||
-			(level != XLAT_TABLE_LEVEL_MAX)) {
-			WARN("Address %p is not mapped at the right granularity.\n",
-			     (void *)base_va);
-			WARN("Granularity is 0x%llx, should be 0x%x.\n",
-			     (unsigned long long)XLAT_BLOCK_SIZE(level), PAGE_SIZE);
-			return -EINVAL;
-		}
-
-		/*
-		 * If the region type is device, it shouldn't be executable.
-		 */
-		int attr_index = (desc >> ATTR_INDEX_SHIFT) & ATTR_INDEX_MASK;
-		if (attr_index == ATTR_DEVICE_INDEX) {
-			if ((attr & MT_EXECUTE_NEVER) == 0) {
-				WARN("Setting device memory as executable at address %p.",
-				     (void *)base_va);
-				return -EINVAL;
-			}
-		}
-
-		base_va += PAGE_SIZE;
+	int tables_needed = 0;
+	int rc = xlat_change_mem_attr_check(ctx, ctx->base_table, 0,
+					    ctx->base_table_entries,
+					    ctx->base_level, base_va, end_va,
+					    attr, &tables_needed);
+	if (rc != 0)
+		return rc;
+
+	if (tables_needed > xlat_tables_free_count(ctx)) {
+		WARN("%s: %i translation tables needed to split blocks, %i available.\n",
+		     __func__, tables_needed, xlat_tables_free_count(ctx));
+		return -ENOMEM;
 	}
 
-	/* Restore original value. */
-	base_va = base_va_original;
-
 	VERBOSE("%s: All pages are mapped, now changing their attributes...\n",
 		__func__);
 
-	for (int i = 0; i < pages_count; ++i) {
-
-		mmap_attr_t old_attr, new_attr;
-		uint64_t *entry;
-		int level;
-		unsigned long long addr_pa;
-
-		get_mem_attributes_internal(ctx, base_va, &old_attr,
-					    &entry, &addr_pa, &level);
-
-		VERBOSE("Old attributes: 0x%x\n", old_attr);
-
-		/*
-		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
-		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
-		 * information is ignored.
-		 */
-
-		/* Clean the old attributes so that they can be rebuilt. */
-		new_attr = old_attr & ~(MT_RW|MT_EXECUTE_NEVER|MT_USER);
-
-		/*
-		 * Update attributes, but filter out the ones this function
-		 * isn't allowed to change.
-		 */
-		new_attr |= attr & (MT_RW|MT_EXECUTE_NEVER|MT_USER);
-
-		VERBOSE("New attributes: 0x%x\n", new_attr);
-
-		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
-		 */
-		*entry = INVALID_DESC;
+	/*
+	 * The break-before-make sequence requires writing invalid descriptors
+	 * and making sure that the system sees the change before writing the
+	 * new descriptors. All the entries are broken first, so that the TLBs
+	 * are invalidated and synchronised only once for the whole range.
+	 */
+	int tlbi_va = (size / PAGE_SIZE) <= XLAT_TLBI_VA_MAX_PAGES;
 
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va_regime(base_va, ctx->xlat_regime);
+	xlat_change_mem_attr_break(ctx, ctx->base_table, 0,
+				   ctx->base_table_entries, ctx->base_level,
+				   base_va, end_va, attr, tlbi_va);
 
-		/* Ensure completion of the invalidation. */
-		xlat_arch_tlbi_va_sync();
+	/* Invalidate any cached copy of these mappings in the TLBs. */
+	if (!tlbi_va)
+		xlat_arch_tlbi_all_regime(ctx->xlat_regime);
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
+	/* Ensure completion of the invalidation. */
+	xlat_arch_tlbi_va_sync();
 
-		base_va += PAGE_SIZE;
-	}
+	/* Write new descriptors */
+	xlat_change_mem_attr_make(ctx, ctx->base_table, 0,
+				  ctx->base_table_entries, ctx->base_level,
+				  base_va, end_va, attr);
 
 	/* Ensure that the last descriptor writen is seen by the system. */
 	dsbish();
@@ -53,6 +53,13 @@ typedef enum  {
 void xlat_arch_tlbi_va(uintptr_t va);
 void xlat_arch_tlbi_va_regime(uintptr_t va, xlat_regime_t xlat_regime);
 
+/*
+ * Invalidate all TLB entries of the given translation regime, in the same
+ * Inner Shareable domain as for xlat_arch_tlbi_va_regime(). It can be used
+ * instead of invalidating a large number of entries one at a time.
+ */
+void xlat_arch_tlbi_all_regime(xlat_regime_t xlat_regime);
+
 /*
  * This function has to be called at the end of any code that uses the function
  * xlat_arch_tlbi_va().
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -48,21 +48,39 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch FP registers lazily, on first use after a world switch
+CTX_LAZY_FPREGS			:= 0
+
 # Debug build
 DEBUG				:= 0
 
 # Build platform
 DEFAULT_PLAT			:= fvp
 
+# Flag to output log messages as binary records instead of text
+ENABLE_BINARY_LOG		:= 0
+
+# Flag to enable the profiling of the BL31 spin and bakery locks
+ENABLE_LOCK_PROF		:= 0
+
+# Flag to enable the deferred output of the BL31 runtime log messages
+ENABLE_LOG_RING			:= 0
+
 # Flag to enable Performance Measurement Framework
 ENABLE_PMF			:= 0
 
+# Flag to enable the per-CPU PMF trace buffers
+ENABLE_PMF_TRACE		:= 0
+
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Flag to enable per-service and per-function SMC statistics
+ENABLE_SMC_STATS		:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
@@ -108,6 +126,9 @@ NS_TIMER_SWITCH			:= 0
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
+# Flag to generate the translation tables of BL31 at build time
+PREGENERATE_XLAT_TABLES		:= 0
+
 # By default, consider that the platform's reset address is not programmable.
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
@@ -116,6 +137,10 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Original format.
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Flag to let CPU_SUSPEND skip the power domain locks when the calling CPU is
+# not the last one running in its cluster.
+PSCI_LOCKLESS_SUSPEND		:= 0
+
 # By default, BL1 acts as the reset handler, not BL31
 RESET_TO_BL31			:= 0
 
@@ -145,6 +170,14 @@ TRUSTED_BOARD_BOOT		:= 0
 # Build option to choose whether Trusted firmware uses Coherent memory or not.
 USE_COHERENT_MEM		:= 1
 
+# Use the byte-at-a-time implementations of the mem* functions of the C
+# library, which are smaller but slower than the default ones.
+USE_SMALL_MEM_FUNCS		:= 0
+
+# Implement spin locks as ticket locks, which are fair, rather than
+# test-and-set locks.
+USE_TICKET_SPINLOCKS		:= 0
+
 # Use tbbr_oid.h instead of platform_oid.h
 USE_TBBR_DEFS			= $(ERROR_DEPRECATED)
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arm_def.h>
+#include <arm_spm_def.h>
+#include <arm_xlat_tables.h>
+#include <plat_arm.h>
+#include <v2m_def.h>
+#include "../fvp_def.h"
+#include "fvp_private.h"
+
+/*
+ * Table of memory regions for BL31 to map using the MMU. This doesn't include
+ * Trusted SRAM as arm_setup_page_tables() already takes care of mapping it.
+ *
+ * It is kept apart from the rest of the FVP port so that it can also be built
+ * for the host by xlat_tables_gen, when the translation tables of BL31 are
+ * generated at build time.
+ */
+const mmap_region_t plat_arm_mmap[] = {
+	ARM_MAP_SHARED_RAM,
+	ARM_MAP_EL3_TZC_DRAM,
+	V2M_MAP_IOFPGA,
+	MAP_DEVICE0,
+	MAP_DEVICE1,
+	ARM_V2M_MAP_MEM_PROTECT,
+#if ENABLE_SPM
+	ARM_SPM_BUF_EL3_MMAP,
+#endif
+#if defined(PLAT_PMF_TRACE_NS_BUF_BASE) || defined(PLAT_PSCI_STAT_NS_BUF_BASE)
+	ARM_MAP_NS_SHARED_MEM,
+#endif
+	{0}
+};
+
+ARM_CASSERT_MMAP
@@ -34,27 +34,10 @@
  ******************************************************************************/
 arm_config_t arm_config;
 
-#define MAP_DEVICE0	MAP_REGION_FLAT(DEVICE0_BASE,			\
-					DEVICE0_SIZE,			\
-					MT_DEVICE | MT_RW | MT_SECURE)
-
-#define MAP_DEVICE1	MAP_REGION_FLAT(DEVICE1_BASE,			\
-					DEVICE1_SIZE,			\
-					MT_DEVICE | MT_RW | MT_SECURE)
-
-/*
- * Need to be mapped with write permissions in order to set a new non-volatile
- * counter value.
- */
-#define MAP_DEVICE2	MAP_REGION_FLAT(DEVICE2_BASE,			\
-					DEVICE2_SIZE,			\
-					MT_DEVICE | MT_RW | MT_SECURE)
-
-
 /*
  * Table of memory regions for various BL stages to map using the MMU.
  * This doesn't include Trusted SRAM as arm_setup_page_tables() already
- * takes care of mapping it.
+ * takes care of mapping it. The table of BL31 is in fvp_bl31_mmap.c.
  *
  * The flash needs to be mapped as writable in order to erase the FIP's Table of
  * Contents in case of unrecoverable error (see plat_error_handler()).
@@ -113,20 +96,6 @@ const mmap_region_t plat_arm_mmap[] = {
 	{0}
 };
 #endif
-#ifdef IMAGE_BL31
-const mmap_region_t plat_arm_mmap[] = {
-	ARM_MAP_SHARED_RAM,
-	ARM_MAP_EL3_TZC_DRAM,
-	V2M_MAP_IOFPGA,
-	MAP_DEVICE0,
-	MAP_DEVICE1,
-	ARM_V2M_MAP_MEM_PROTECT,
-#if ENABLE_SPM
-	ARM_SPM_BUF_EL3_MMAP,
-#endif
-	{0}
-};
-
 #if ENABLE_SPM && defined(IMAGE_BL31)
 const mmap_region_t plat_arm_secure_partition_mmap[] = {
 	V2M_MAP_IOFPGA_EL0, /* for the UART */
@@ -140,7 +109,6 @@ const mmap_region_t plat_arm_secure_partition_mmap[] = {
 	{0}
 };
 #endif
-#endif
 #ifdef IMAGE_BL32
 const mmap_region_t plat_arm_mmap[] = {
 #ifdef AARCH32
@@ -149,11 +117,16 @@ const mmap_region_t plat_arm_mmap[] = {
 	V2M_MAP_IOFPGA,
 	MAP_DEVICE0,
 	MAP_DEVICE1,
+#if defined(AARCH32) && defined(PLAT_PMF_TRACE_NS_BUF_BASE)
+	ARM_MAP_NS_SHARED_MEM,
+#endif
 	{0}
 };
 #endif
 
+#ifndef IMAGE_BL31
 ARM_CASSERT_MMAP
+#endif
 
 #if FVP_INTERCONNECT_DRIVER != FVP_CCN
 static const int fvp_cci400_map[] = {
@@ -36,6 +36,9 @@ const unsigned int arm_pm_idle_states[] = {
 	/* State-id - 0x02 */
 	arm_make_pwrstate_lvl1(ARM_LOCAL_STATE_RUN, ARM_LOCAL_STATE_OFF,
 			ARM_PWR_LVL0, PSTATE_TYPE_POWERDOWN),
+	/* State-id - 0x11 */
+	arm_make_pwrstate_lvl1(ARM_LOCAL_STATE_RET, ARM_LOCAL_STATE_RET,
+			ARM_PWR_LVL1, PSTATE_TYPE_STANDBY),
 	/* State-id - 0x22 */
 	arm_make_pwrstate_lvl1(ARM_LOCAL_STATE_OFF, ARM_LOCAL_STATE_OFF,
 			ARM_PWR_LVL1, PSTATE_TYPE_POWERDOWN),
@@ -198,8 +201,8 @@ static void fvp_pwr_domain_suspend(const psci_power_state_t *target_state)
 	unsigned long mpidr;
 
 	/*
-	 * FVP has retention only at cpu level. Just return
-	 * as nothing is to be done for retention.
+	 * Retention is only a WFI on FVP, at cpu and cluster level. Just
+	 * return as nothing is to be done for retention.
 	 */
 	if (target_state->pwr_domain_state[ARM_PWR_LVL0] ==
 					ARM_LOCAL_STATE_RET)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -50,6 +50,37 @@
  */
 #define PLAT_ARM_NS_IMAGE_OFFSET	(ARM_DRAM1_BASE + 0x8000000)
 
+/*
+ * Buffer of the Non-secure shared memory that PMF_SMC_TRACE_READ copies the
+ * trace events to
+ */
+#if ENABLE_PMF_TRACE
+#define PLAT_PMF_TRACE_NS_BUF_BASE	ARM_NS_SHARED_MEM_BASE
+#define PLAT_PMF_TRACE_NS_BUF_SIZE	(ARM_NS_SHARED_MEM_SIZE / 2)
+#endif
+
+/*
+ * Buffer of the Non-secure shared memory that the PSCI statistics snapshots
+ * are written to
+ */
+#if ENABLE_PSCI_STAT
+#define PLAT_PSCI_STAT_NS_BUF_BASE	(ARM_NS_SHARED_MEM_BASE +	\
+					 ARM_NS_SHARED_MEM_SIZE / 2)
+#define PLAT_PSCI_STAT_NS_BUF_SIZE	(ARM_NS_SHARED_MEM_SIZE / 2)
+#endif
+
+/*
+ * Fixed end of the code and of the read-only data of BL31, which its
+ * translation tables are generated for at build time. The generated tables are
+ * initialised data, so the rest of BL31 must still fit below BL31_PROGBITS_LIMIT
+ * when BL31 is in Trusted SRAM. The linker script fails the build if any of
+ * these limits is exceeded.
+ */
+#if PREGENERATE_XLAT_TABLES
+#define BL31_TEXT_LIMIT			(BL31_BASE + 0xC000)
+#define BL31_RODATA_LIMIT		(BL31_TEXT_LIMIT + 0x3000)
+#endif
+
 
 /*
  * PL011 related constants
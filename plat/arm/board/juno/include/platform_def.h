@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -86,7 +86,12 @@
 
 #ifdef IMAGE_BL31
 #  define PLAT_ARM_MMAP_ENTRIES		7
+# if ENABLE_PSCI_STAT
+/* One more table maps the Non-secure shared memory at the top of DRAM1 */
+#  define MAX_XLAT_TABLES		4
+# else
 #  define MAX_XLAT_TABLES		3
+# endif
 #endif
 
 #ifdef IMAGE_BL32
@@ -145,6 +150,15 @@
 
 #endif /* ARM_BOARD_OPTIMISE_MEM */
 
+/*
+ * Buffer of the Non-secure shared memory that the PSCI statistics snapshots
+ * are written to
+ */
+#if ENABLE_PSCI_STAT
+#define PLAT_PSCI_STAT_NS_BUF_BASE	ARM_NS_SHARED_MEM_BASE
+#define PLAT_PSCI_STAT_NS_BUF_SIZE	ARM_NS_SHARED_MEM_SIZE
+#endif
+
 /* CCI related constants */
 #define PLAT_ARM_CCI_BASE		0x2c090000
 #define PLAT_ARM_CCI_CLUSTER0_SL_IFACE_IX	4
@@ -48,6 +48,13 @@ void arm_setup_page_tables(uintptr_t total_base,
 #endif
 			   )
 {
+#if PREGENERATE_XLAT_TABLES && defined(IMAGE_BL31)
+	/*
+	 * The same regions have been mapped at build time, for the fixed layout
+	 * of BL31 given by BL31_TEXT_LIMIT and BL31_RODATA_LIMIT.
+	 * init_xlat_tables() checks that they match the BL31 image.
+	 */
+#else
 	/*
 	 * Map the Trusted SRAM with appropriate memory attributes.
 	 * Subsequent mappings will adjust the attributes for specific regions.
@@ -91,6 +98,7 @@ void arm_setup_page_tables(uintptr_t total_base,
 
 	/* Now (re-)map the platform-specific memory regions */
 	mmap_add(plat_arm_get_mmap());
+#endif /* PREGENERATE_XLAT_TABLES && defined(IMAGE_BL31) */
 
 	/* Create the page tables to reflect the above mappings */
 	init_xlat_tables();
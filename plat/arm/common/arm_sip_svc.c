@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,11 +7,22 @@
 #include <arm_sip_svc.h>
 #include <debug.h>
 #include <plat_arm.h>
+#include <platform_def.h>
 #include <pmf.h>
+#include <psci.h>
 #include <runtime_svc.h>
 #include <stdint.h>
 #include <uuid.h>
 
+/*
+ * The PSCI stats snapshot is only implemented when the platform sets aside a
+ * Non-secure buffer for it.
+ */
+#if ENABLE_PSCI_STAT && defined(PLAT_PSCI_STAT_NS_BUF_BASE)
+#define ARM_SIP_PSCI_STAT_SNAPSHOT	1
+#else
+#define ARM_SIP_PSCI_STAT_SNAPSHOT	0
+#endif
 
 /* ARM SiP Service UUID */
 DEFINE_SVC_UUID(arm_sip_svc_uid,
@@ -38,6 +49,10 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 			u_register_t flags)
 {
 	int call_count = 0;
+#if ARM_SIP_PSCI_STAT_SNAPSHOT
+	size_t size_written;
+	int rc;
+#endif
 
 	/*
 	 * Dispatch PMF calls to PMF SMC handler and return its return
@@ -69,6 +84,31 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				handle);
 		}
 
+#if ARM_SIP_PSCI_STAT_SNAPSHOT
+	case ARM_SIP_SVC_PSCI_STAT_SNAPSHOT_32:
+		x1 = (uint32_t)x1;
+		x2 = (uint32_t)x2;
+		/* Fall through */
+
+	case ARM_SIP_SVC_PSCI_STAT_SNAPSHOT_64:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, PSCI_E_DENIED);
+
+		rc = psci_stat_snapshot(x1, x2, &size_written);
+		SMC_RET2(handle, rc, size_written);
+#endif
+
+#if ENABLE_LOG_RING
+	case ARM_SIP_SVC_LOG_FLUSH:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		tf_log_ring_flush();
+		SMC_RET1(handle, SMC_OK);
+#endif
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +116,16 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if ARM_SIP_PSCI_STAT_SNAPSHOT
+		/* PSCI stats snapshot calls */
+		call_count += 2;
+#endif
+
+#if ENABLE_LOG_RING
+		/* Log flush call */
+		call_count += 1;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <plat_arm.h>
+#include <xlat_tables_v2.h>
+
+/*
+ * Platform-specific memory regions of BL31 for xlat_tables_gen, when the
+ * translation tables of BL31 are generated at build time. They are the regions
+ * that arm_setup_page_tables() maps after the BL31 image at cold boot, so a
+ * platform that overrides plat_arm_get_mmap() must provide its own version.
+ */
+const mmap_region_t *plat_xlat_tables_gen_get_mmap(void)
+{
+	return plat_arm_mmap;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -103,11 +103,12 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 	 * To avoid the additional overhead in PSCI flow, skip FP context
 	 * saving/restoring in case of CPU suspend and resume, asssuming that
 	 * when it's needed the PSCI caller has preserved FP context before
-	 * going here.
+	 * going here. With CTX_LAZY_FPREGS the restore is still needed, as it
+	 * arms the trap that protects the other world's FP registers.
 	 */
 #if CTX_INCLUDE_FPREGS
 	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_save(get_fpregs_ctx(cm_get_context(security_state)));
+		cm_fpregs_context_save(security_state);
 #endif
 	cm_el1_sysregs_context_save(security_state);
 
@@ -118,8 +119,9 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 
 	cm_el1_sysregs_context_restore(security_state);
 #if CTX_INCLUDE_FPREGS
-	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+	if (CTX_LAZY_FPREGS ||
+	    (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME))
+		cm_fpregs_context_restore(security_state);
 #endif
 
 	cm_set_next_eret_context(security_state);
@@ -264,6 +264,28 @@ int32_t tspd_init(void)
 	return rc;
 }
 
+/*******************************************************************************
+ * These functions save and restore the EL1 context of the given security state
+ * around a TSP service call. The TSP handles fast SMCs without touching the EL1
+ * registers outside the partial context, so only those are switched for them.
+ * In particular, the non-secure timer registers are not switched around fast
+ * SMCs even if NS_TIMER_SWITCH is set.
+ ******************************************************************************/
+static void tspd_el1_context_save(uint32_t security_state, uint32_t smc_fid)
+{
+	if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+		cm_el1_sysregs_context_save_partial(security_state);
+	else
+		cm_el1_sysregs_context_save(security_state);
+}
+
+static void tspd_el1_context_restore(uint32_t security_state, uint32_t smc_fid)
+{
+	if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+		cm_el1_sysregs_context_restore_partial(security_state);
+	else
+		cm_el1_sysregs_context_restore(security_state);
+}
 
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
@@ -485,11 +507,13 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 	case TSP_FAST_FID(TSP_SUB):
 	case TSP_FAST_FID(TSP_MUL):
 	case TSP_FAST_FID(TSP_DIV):
+	case TSP_FAST_FID(TSP_NOP):
 
 	case TSP_YIELD_FID(TSP_ADD):
 	case TSP_YIELD_FID(TSP_SUB):
 	case TSP_YIELD_FID(TSP_MUL):
 	case TSP_YIELD_FID(TSP_DIV):
+	case TSP_YIELD_FID(TSP_NOP):
 		if (ns) {
 			/*
 			 * This is a fresh request from the non-secure client.
@@ -503,7 +527,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			if (get_yield_smc_active_flag(tsp_ctx->state))
 				SMC_RET1(handle, SMC_UNK);
 
-			cm_el1_sysregs_context_save(NON_SECURE);
+			tspd_el1_context_save(NON_SECURE, smc_fid);
 
 			/* Save x1 and x2 for use by TSP_GET_ARGS call below */
 			store_tsp_args(tsp_ctx, x1, x2);
@@ -556,7 +580,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 #endif
 			}
 
-			cm_el1_sysregs_context_restore(SECURE);
+			tspd_el1_context_restore(SECURE, smc_fid);
 			cm_set_next_eret_context(SECURE);
 			SMC_RET3(&tsp_ctx->cpu_ctx, smc_fid, x1, x2);
 		} else {
@@ -567,14 +591,14 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * and return to the non-secure state.
 			 */
 			assert(handle == cm_get_context(SECURE));
-			cm_el1_sysregs_context_save(SECURE);
+			tspd_el1_context_save(SECURE, smc_fid);
 
 			/* Get a reference to the non-secure context */
 			ns_cpu_context = cm_get_context(NON_SECURE);
 			assert(ns_cpu_context);
 
 			/* Restore non-secure state */
-			cm_el1_sysregs_context_restore(NON_SECURE);
+			tspd_el1_context_restore(NON_SECURE, smc_fid);
 			cm_set_next_eret_context(NON_SECURE);
 			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_YIELD) {
 				clr_yield_smc_active_flag(tsp_ctx->state);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -48,6 +48,59 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/*
+ * Number of statically bound maps at the start of each mapping's interrupt
+ * index. The remaining entries of the index are the dynamic maps.
+ */
+static unsigned int num_static_maps[_SDEI_MAP_IDX_MAX];
+
+/*
+ * Build the interrupt index of each mapping. Statically bound maps never
+ * change their interrupt, so they're sorted by interrupt number for binary
+ * search. Dynamic maps are bound and released at runtime, so they're kept
+ * apart, in the order in which they appear in the mapping.
+ */
+void sdei_init_intr_index(void)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_map_t *map;
+	unsigned int i, j, k, n;
+
+	for_each_mapping_type(i, mapping) {
+		n = 0;
+		iterate_mapping(mapping, j, map) {
+			if (is_map_dynamic(map))
+				continue;
+
+			/* Insertion sort; mappings are small and sorted once */
+			for (k = n; (k > 0) &&
+					(mapping->intr_index[k - 1]->intr >
+					 map->intr); k--)
+				mapping->intr_index[k] =
+					mapping->intr_index[k - 1];
+			mapping->intr_index[k] = map;
+			n++;
+		}
+
+		num_static_maps[i] = n;
+
+		iterate_mapping(mapping, j, map) {
+			if (is_map_dynamic(map))
+				mapping->intr_index[n++] = map;
+		}
+
+		assert(n == mapping->num_maps);
+
+#if ENABLE_ASSERTIONS
+		/* No two statically bound maps may share an interrupt */
+		for (k = 1; k < num_static_maps[i]; k++) {
+			assert(mapping->intr_index[k - 1]->intr !=
+					mapping->intr_index[k]->intr);
+		}
+#endif
+	}
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -56,16 +109,33 @@ sdei_ev_map_t *find_event_map_by_intr(int intr_num, int shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i;
+	unsigned int idx, lo, hi, mid;
+
+	idx = shared ? _SDEI_MAP_IDX_SHRD : _SDEI_MAP_IDX_PRIV;
+	mapping = &sdei_global_mappings[idx];
+
+	/* Binary search amongst the statically bound maps */
+	lo = 0;
+	hi = num_static_maps[idx];
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2);
+		map = mapping->intr_index[mid];
+		if (map->intr == (unsigned int) intr_num)
+			return map;
+
+		if (map->intr < (unsigned int) intr_num)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
 
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Dynamic maps change interrupts at runtime, so search them linearly.
+	 * There are only as many of them as there are bind slots.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
-	iterate_mapping(mapping, i, map) {
-		if (map->intr == intr_num)
+	for (mid = num_static_maps[idx]; mid < mapping->num_maps; mid++) {
+		map = mapping->intr_index[mid];
+		if (map->intr == (unsigned int) intr_num)
 			return map;
 	}
 
@@ -80,17 +150,25 @@ sdei_ev_map_t *find_event_map(int ev_num)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i, j;
+	unsigned int i, lo, hi, mid;
 
 	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
+	 * The mappings are required to be sorted in the increasing order of
+	 * event number, so binary search each of them.
 	 */
 	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
+		lo = 0;
+		hi = mapping->num_maps;
+		while (lo < hi) {
+			mid = lo + ((hi - lo) / 2);
+			map = &mapping->map[mid];
 			if (map->ev_num == ev_num)
 				return map;
+
+			if (map->ev_num < ev_num)
+				lo = mid + 1;
+			else
+				hi = mid;
 		}
 	}
 
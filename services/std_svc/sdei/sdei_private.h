@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -216,6 +216,7 @@ extern sdei_entry_t sdei_private_event_table[];
 extern sdei_entry_t sdei_shared_event_table[];
 
 void init_sdei_state(void);
+void sdei_init_intr_index(void);
 
 sdei_ev_map_t *find_event_map_by_intr(int intr_num, int shared);
 sdei_ev_map_t *find_event_map(int ev_num);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -36,57 +36,10 @@ REGISTER_XLAT_CONTEXT2(secure_partition,
 /* Export a handle on the secure partition translation context */
 xlat_ctx_t *secure_partition_xlat_ctx_handle = &secure_partition_xlat_ctx;
 
-/* Setup context of the Secure Partition */
+/* Setup the resources shared by all contexts of the Secure Partition */
 void secure_partition_setup(void)
 {
-	VERBOSE("S-EL1/S-EL0 context setup start...\n");
-
-	cpu_context_t *ctx = cm_get_context(SECURE);
-
-	/* Make sure that we got a Secure context. */
-	assert(ctx != NULL);
-
-	/* Assert we are in Secure state. */
-	assert((read_scr_el3() & SCR_NS_BIT) == 0);
-
-	/* Disable MMU at EL1. */
-	disable_mmu_icache_el1();
-
-	/* Invalidate TLBs at EL1. */
-	tlbivmalle1();
-	dsbish();
-
-	/*
-	 * General-Purpose registers
-	 * -------------------------
-	 */
-
-	/*
-	 * X0: Virtual address of a buffer shared between EL3 and Secure EL0.
-	 *     The buffer will be mapped in the Secure EL1 translation regime
-	 *     with Normal IS WBWA attributes and RO data and Execute Never
-	 *     instruction access permissions.
-	 *
-	 * X1: Size of the buffer in bytes
-	 *
-	 * X2: cookie value (Implementation Defined)
-	 *
-	 * X3: cookie value (Implementation Defined)
-	 *
-	 * X4 to X30 = 0 (already done by cm_init_my_context())
-	 */
-	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0, PLAT_SPM_BUF_BASE);
-	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X1, PLAT_SPM_BUF_SIZE);
-	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X2, PLAT_SPM_COOKIE_0);
-	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X3, PLAT_SPM_COOKIE_1);
-
-	/*
-	 * SP_EL0: A non-zero value will indicate to the SP that the SPM has
-	 * initialized the stack pointer for the current CPU through
-	 * implementation defined means. The value will be 0 otherwise.
-	 */
-	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_SP_EL0,
-			PLAT_SP_IMAGE_STACK_BASE + PLAT_SP_IMAGE_STACK_PCPU_SIZE);
+	VERBOSE("S-EL1/S-EL0 shared resources setup start...\n");
 
 	/*
 	 * Setup translation tables
@@ -151,6 +104,138 @@ void secure_partition_setup(void)
 
 	init_xlat_tables_ctx(&secure_partition_xlat_ctx);
 
+	/*
+	 * Prepare information in buffer shared between EL3 and S-EL0
+	 * ----------------------------------------------------------
+	 */
+
+	void *shared_buf_ptr = (void *) PLAT_SPM_BUF_BASE;
+
+	/* Copy the boot information into the shared buffer with the SP. */
+	assert((uintptr_t)shared_buf_ptr + sizeof(secure_partition_boot_info_t)
+	       <= (PLAT_SPM_BUF_BASE + PLAT_SPM_BUF_SIZE));
+
+	assert(PLAT_SPM_BUF_BASE <= (UINTPTR_MAX - PLAT_SPM_BUF_SIZE + 1));
+
+	const secure_partition_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+
+	assert(sp_boot_info != NULL);
+
+	memcpy((void *) shared_buf_ptr, (const void *) sp_boot_info,
+	       sizeof(secure_partition_boot_info_t));
+
+	/* Pointer to the MP information from the platform port. */
+	secure_partition_mp_info_t *sp_mp_info =
+		((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info;
+
+	assert(sp_mp_info != NULL);
+
+	/*
+	 * Point the shared buffer MP information pointer to where the info will
+	 * be populated, just after the boot info.
+	 */
+	((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info =
+		(secure_partition_mp_info_t *) ((uintptr_t)shared_buf_ptr
+				+ sizeof(secure_partition_boot_info_t));
+
+	/*
+	 * Update the shared buffer pointer to where the MP information for the
+	 * payload will be populated
+	 */
+	shared_buf_ptr = ((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info;
+
+	/*
+	 * Copy the cpu information into the shared buffer area after the boot
+	 * information.
+	 */
+	assert(sp_boot_info->num_cpus <= PLATFORM_CORE_COUNT);
+
+	assert((uintptr_t)shared_buf_ptr
+	       <= (PLAT_SPM_BUF_BASE + PLAT_SPM_BUF_SIZE -
+		       (sp_boot_info->num_cpus * sizeof(*sp_mp_info))));
+
+	memcpy(shared_buf_ptr, (const void *) sp_mp_info,
+		sp_boot_info->num_cpus * sizeof(*sp_mp_info));
+
+	/*
+	 * Calculate the linear indices of cores in boot information for the
+	 * secure partition and flag the primary CPU
+	 */
+	sp_mp_info = (secure_partition_mp_info_t *) shared_buf_ptr;
+
+	for (unsigned int index = 0; index < sp_boot_info->num_cpus; index++) {
+		u_register_t mpidr = sp_mp_info[index].mpidr;
+
+		sp_mp_info[index].linear_id = plat_core_pos_by_mpidr(mpidr);
+		if (plat_my_core_pos() == sp_mp_info[index].linear_id)
+			sp_mp_info[index].flags |= MP_INFO_FLAG_PRIMARY_CPU;
+	}
+
+	VERBOSE("S-EL1/S-EL0 shared resources setup end.\n");
+}
+
+/*
+ * Setup the given execution context of the Secure Partition in the current
+ * secure CPU context.
+ */
+void secure_partition_context_setup(unsigned int ctx_idx)
+{
+	VERBOSE("S-EL1/S-EL0 context %u setup start...\n", ctx_idx);
+
+	cpu_context_t *ctx = cm_get_context(SECURE);
+
+	/* Make sure that we got a Secure context. */
+	assert(ctx != NULL);
+
+	/* Assert we are in Secure state. */
+	assert((read_scr_el3() & SCR_NS_BIT) == 0);
+
+	/* Disable MMU at EL1. */
+	disable_mmu_icache_el1();
+
+	/* Invalidate TLBs at EL1. */
+	tlbivmalle1();
+	dsbish();
+
+	/*
+	 * General-Purpose registers
+	 * -------------------------
+	 */
+
+	/*
+	 * X0: Virtual address of a buffer shared between EL3 and Secure EL0.
+	 *     The buffer will be mapped in the Secure EL1 translation regime
+	 *     with Normal IS WBWA attributes and RO data and Execute Never
+	 *     instruction access permissions.
+	 *
+	 * X1: Size of the buffer in bytes
+	 *
+	 * X2: cookie value (Implementation Defined)
+	 *
+	 * X3: cookie value (Implementation Defined)
+	 *
+	 * X4: Index of the execution context being initialised. The partition
+	 *     is entered once for each of its contexts, starting with 0.
+	 *
+	 * X5 to X30 = 0 (already done by cm_init_my_context())
+	 */
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X0, PLAT_SPM_BUF_BASE);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X1, PLAT_SPM_BUF_SIZE);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X2, PLAT_SPM_COOKIE_0);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X3, PLAT_SPM_COOKIE_1);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X4, ctx_idx);
+
+	/*
+	 * SP_EL0: A non-zero value will indicate to the SP that the SPM has
+	 * initialized the stack pointer for the current CPU through
+	 * implementation defined means. The value will be 0 otherwise. Each
+	 * context uses its own per-CPU stack of the partition.
+	 */
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_SP_EL0,
+			PLAT_SP_IMAGE_STACK_BASE +
+			(ctx_idx + 1) * PLAT_SP_IMAGE_STACK_PCPU_SIZE);
+
 	/*
 	 * MMU-related registers
 	 * ---------------------
@@ -243,73 +328,5 @@ void secure_partition_setup(void)
 	write_ctx_reg(get_sysregs_ctx(ctx), CTX_CPACR_EL1,
 			CPACR_EL1_FPEN(CPACR_EL1_FP_TRAP_ALL));
 
-	/*
-	 * Prepare information in buffer shared between EL3 and S-EL0
-	 * ----------------------------------------------------------
-	 */
-
-	void *shared_buf_ptr = (void *) PLAT_SPM_BUF_BASE;
-
-	/* Copy the boot information into the shared buffer with the SP. */
-	assert((uintptr_t)shared_buf_ptr + sizeof(secure_partition_boot_info_t)
-	       <= (PLAT_SPM_BUF_BASE + PLAT_SPM_BUF_SIZE));
-
-	assert(PLAT_SPM_BUF_BASE <= (UINTPTR_MAX - PLAT_SPM_BUF_SIZE + 1));
-
-	const secure_partition_boot_info_t *sp_boot_info =
-			plat_get_secure_partition_boot_info(NULL);
-
-	assert(sp_boot_info != NULL);
-
-	memcpy((void *) shared_buf_ptr, (const void *) sp_boot_info,
-	       sizeof(secure_partition_boot_info_t));
-
-	/* Pointer to the MP information from the platform port. */
-	secure_partition_mp_info_t *sp_mp_info =
-		((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info;
-
-	assert(sp_mp_info != NULL);
-
-	/*
-	 * Point the shared buffer MP information pointer to where the info will
-	 * be populated, just after the boot info.
-	 */
-	((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info =
-		(secure_partition_mp_info_t *) ((uintptr_t)shared_buf_ptr
-				+ sizeof(secure_partition_boot_info_t));
-
-	/*
-	 * Update the shared buffer pointer to where the MP information for the
-	 * payload will be populated
-	 */
-	shared_buf_ptr = ((secure_partition_boot_info_t *) shared_buf_ptr)->mp_info;
-
-	/*
-	 * Copy the cpu information into the shared buffer area after the boot
-	 * information.
-	 */
-	assert(sp_boot_info->num_cpus <= PLATFORM_CORE_COUNT);
-
-	assert((uintptr_t)shared_buf_ptr
-	       <= (PLAT_SPM_BUF_BASE + PLAT_SPM_BUF_SIZE -
-		       (sp_boot_info->num_cpus * sizeof(*sp_mp_info))));
-
-	memcpy(shared_buf_ptr, (const void *) sp_mp_info,
-		sp_boot_info->num_cpus * sizeof(*sp_mp_info));
-
-	/*
-	 * Calculate the linear indices of cores in boot information for the
-	 * secure partition and flag the primary CPU
-	 */
-	sp_mp_info = (secure_partition_mp_info_t *) shared_buf_ptr;
-
-	for (unsigned int index = 0; index < sp_boot_info->num_cpus; index++) {
-		u_register_t mpidr = sp_mp_info[index].mpidr;
-
-		sp_mp_info[index].linear_id = plat_core_pos_by_mpidr(mpidr);
-		if (plat_my_core_pos() == sp_mp_info[index].linear_id)
-			sp_mp_info[index].flags |= MP_INFO_FLAG_PRIMARY_CPU;
-	}
-
-	VERBOSE("S-EL1/S-EL0 context setup end.\n");
+	VERBOSE("S-EL1/S-EL0 context %u setup end.\n", ctx_idx);
 }
@@ -7,6 +7,7 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl31.h>
+#include <cassert.h>
 #include <context_mgmt.h>
 #include <debug.h>
 #include <errno.h>
@@ -26,10 +27,44 @@
 /* Lock used for SP_MEMORY_ATTRIBUTES_GET and SP_MEMORY_ATTRIBUTES_SET */
 static spinlock_t mem_attr_smc_lock;
 
+/*
+ * Number of execution contexts of the Secure Partition. Each CPU is statically
+ * assigned one of them, so requests from CPUs that use different contexts are
+ * handled in parallel. By default there is a single context, which serializes
+ * all requests. Platforms whose partition supports concurrent execution can
+ * define it up to PLATFORM_CORE_COUNT, the number of per-CPU stacks reserved
+ * for the partition.
+ */
+#ifndef PLAT_SP_CONTEXT_COUNT
+#define PLAT_SP_CONTEXT_COUNT		1
+#endif
+
+CASSERT((PLAT_SP_CONTEXT_COUNT > 0) &&
+	(PLAT_SP_CONTEXT_COUNT <= PLATFORM_CORE_COUNT),
+	assert_plat_sp_context_count_out_of_range);
+
 /*******************************************************************************
  * Secure Partition context information.
  ******************************************************************************/
-static secure_partition_context_t sp_ctx;
+static secure_partition_context_t sp_ctx[PLAT_SP_CONTEXT_COUNT];
+
+/*
+ * Get the Secure Partition context that holds the current secure CPU context.
+ * This is the context assigned to the calling CPU, or the context being
+ * initialised during cold boot.
+ */
+static secure_partition_context_t *spm_get_current_sp_ctx(void)
+{
+	cpu_context_t *ctx = cm_get_context(SECURE);
+	unsigned int idx;
+
+	idx = ((uintptr_t)ctx - (uintptr_t)&sp_ctx[0].cpu_ctx) /
+		sizeof(sp_ctx[0]);
+	assert(idx < PLAT_SP_CONTEXT_COUNT);
+	assert(ctx == &sp_ctx[idx].cpu_ctx);
+
+	return &sp_ctx[idx];
+}
 
 /*******************************************************************************
  * Replace the S-EL1 re-entry information with S-EL0 re-entry
@@ -118,32 +153,64 @@ int32_t spm_init(void)
 	secure_partition_ep_info = bl31_plat_get_next_image_ep_info(SECURE);
 	assert(secure_partition_ep_info);
 
-	/*
-	 * Initialise the common context and then overlay the S-EL0 specific
-	 * context on top of it.
-	 */
-	cm_init_my_context(secure_partition_ep_info);
+	/* Set up the resources shared by all the contexts of the partition */
 	secure_partition_setup();
 
 	/*
-	 * Make all CPUs use the same secure context.
+	 * Initialise each context of the partition in turn on this CPU. For
+	 * each of them, initialise the common context and then overlay the
+	 * S-EL0 specific context on top of it before arranging for an entry
+	 * into the secure partition.
 	 */
-	for (unsigned int i = 0; i < PLATFORM_CORE_COUNT; i++) {
-		cm_set_context_by_index(i, &sp_ctx.cpu_ctx, SECURE);
+	for (unsigned int i = 0; i < PLAT_SP_CONTEXT_COUNT; i++) {
+		cm_set_context(&sp_ctx[i].cpu_ctx, SECURE);
+		cm_init_my_context(secure_partition_ep_info);
+		secure_partition_context_setup(i);
+
+		sp_ctx[i].sp_init_in_progress = 1;
+		rc = spm_synchronous_sp_entry(&sp_ctx[i]);
+		assert(rc == 0);
+		sp_ctx[i].sp_init_in_progress = 0;
 	}
-
-	/*
-	 * Arrange for an entry into the secure partition.
-	 */
-	sp_ctx.sp_init_in_progress = 1;
-	rc = spm_synchronous_sp_entry(&sp_ctx);
-	assert(rc == 0);
-	sp_ctx.sp_init_in_progress = 0;
 	VERBOSE("SP_MEMORY_ATTRIBUTES_SET_AARCH64 availability has been revoked\n");
 
+	/* Assign a context of the partition to each CPU */
+	for (unsigned int i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		cm_set_context_by_index(i,
+				&sp_ctx[i % PLAT_SP_CONTEXT_COUNT].cpu_ctx,
+				SECURE);
+	}
+
 	return rc;
 }
 
+/*******************************************************************************
+ * Return the number of requests delegated to the Secure Partition, or how many
+ * of them had to wait for their context to be released by another CPU, summed
+ * over all the contexts of the partition.
+ ******************************************************************************/
+int spm_stats_get(unsigned int query, unsigned long long *value)
+{
+	assert(value != NULL);
+
+	*value = 0;
+
+	for (unsigned int i = 0; i < PLAT_SP_CONTEXT_COUNT; i++) {
+		switch (query) {
+		case SPM_STATS_REQUESTS:
+			*value += sp_ctx[i].requests;
+			break;
+		case SPM_STATS_CONTENDED:
+			*value += sp_ctx[i].contended;
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
 /*******************************************************************************
  * Given a secure partition entrypoint info pointer, entry point PC & pointer to
  * a context data structure, this function will initialize the SPM context and
@@ -210,7 +277,7 @@ int32_t spm_setup(void)
 
 	spm_init_sp_ep_state(secure_partition_ep_info,
 			      secure_partition_ep_info->pc,
-			      &sp_ctx);
+			      &sp_ctx[0]);
 
 	/*
 	 * All SPM initialization done. Now register our init function with
@@ -330,7 +397,10 @@ static int spm_memory_attributes_set_smc_handler(u_register_t page_address,
 	spin_unlock(&mem_attr_smc_lock);
 
 	/* Convert error codes of change_mem_attributes() into SPM ones. */
-	assert(ret == 0 || ret == -EINVAL);
+	assert(ret == 0 || ret == -EINVAL || ret == -ENOMEM);
+
+	if (ret == -ENOMEM)
+		return SPM_NO_MEMORY;
 
 	return (ret == 0) ? SPM_SUCCESS : SPM_INVALID_PARAMETER;
 }
@@ -346,6 +416,7 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 			 uint64_t flags)
 {
 	cpu_context_t *ns_cpu_context;
+	secure_partition_context_t *sp_ctx_ptr;
 	unsigned int ns;
 
 	/* Determine which security state this SMC originated from */
@@ -365,7 +436,9 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 			cm_el1_sysregs_context_save(SECURE);
 			spm_setup_next_eret_into_sel0(handle);
 
-			if (sp_ctx.sp_init_in_progress) {
+			sp_ctx_ptr = spm_get_current_sp_ctx();
+
+			if (sp_ctx_ptr->sp_init_in_progress) {
 				/*
 				 * SPM reports completion. The SPM must have
 				 * initiated the original request through a
@@ -373,12 +446,14 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 				 * partition. Jump back to the original C
 				 * runtime context.
 				 */
-				spm_synchronous_sp_exit(&sp_ctx, x1);
+				spm_synchronous_sp_exit(sp_ctx_ptr, x1);
 				assert(0);
 			}
 
 			/* Release the Secure Partition context */
-			spin_unlock(&sp_ctx.lock);
+			spin_unlock(&sp_ctx_ptr->lock);
+			(void)__atomic_sub_fetch(&sp_ctx_ptr->users, 1,
+						 __ATOMIC_RELAXED);
 
 			/*
 			 * This is the result from the Secure partition of an
@@ -401,7 +476,7 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 		case SP_MEMORY_ATTRIBUTES_GET_AARCH64:
 			INFO("Received SP_MEMORY_ATTRIBUTES_GET_AARCH64 SMC\n");
 
-			if (!sp_ctx.sp_init_in_progress) {
+			if (!spm_get_current_sp_ctx()->sp_init_in_progress) {
 				WARN("SP_MEMORY_ATTRIBUTES_GET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_NOT_SUPPORTED);
 			}
@@ -410,7 +485,7 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 		case SP_MEMORY_ATTRIBUTES_SET_AARCH64:
 			INFO("Received SP_MEMORY_ATTRIBUTES_SET_AARCH64 SMC\n");
 
-			if (!sp_ctx.sp_init_in_progress) {
+			if (!spm_get_current_sp_ctx()->sp_init_in_progress) {
 				WARN("SP_MEMORY_ATTRIBUTES_SET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_NOT_SUPPORTED);
 			}
@@ -433,6 +508,7 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 			uint64_t mm_cookie = x1;
 			uint64_t comm_buffer_address = x2;
 			uint64_t comm_size_address = x3;
+			unsigned int users;
 
 			/* Cookie. Reserved for future use. It must be zero. */
 			if (mm_cookie != 0) {
@@ -452,18 +528,31 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 			/* Save the Normal world context */
 			cm_el1_sysregs_context_save(NON_SECURE);
 
-			/* Lock the Secure Partition context. */
-			spin_lock(&sp_ctx.lock);
+			/*
+			 * Lock the Secure Partition context assigned to this
+			 * CPU. Other CPUs only contend for it if they share it
+			 * with this one. The request has to wait if another
+			 * CPU was already using the context or waiting for it
+			 * when this one registered as a user.
+			 */
+			sp_ctx_ptr = spm_get_current_sp_ctx();
+			users = __atomic_fetch_add(&sp_ctx_ptr->users, 1,
+						   __ATOMIC_RELAXED);
+
+			spin_lock(&sp_ctx_ptr->lock);
+
+			sp_ctx_ptr->requests++;
+			if (users != 0)
+				sp_ctx_ptr->contended++;
 
 			/*
 			 * Restore the secure world context and prepare for
 			 * entry in S-EL0
 			 */
-			assert(&sp_ctx.cpu_ctx == cm_get_context(SECURE));
 			cm_el1_sysregs_context_restore(SECURE);
 			cm_set_next_eret_context(SECURE);
 
-			SMC_RET4(&sp_ctx.cpu_ctx, smc_fid, comm_buffer_address,
+			SMC_RET4(&sp_ctx_ptr->cpu_ctx, smc_fid, comm_buffer_address,
 				 comm_size_address, plat_my_core_pos());
 		}
 
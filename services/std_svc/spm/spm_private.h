@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -46,6 +46,16 @@ typedef struct secure_partition_context {
 	cpu_context_t cpu_ctx;
 	unsigned int sp_init_in_progress;
 	spinlock_t lock;
+
+	/*
+	 * Number of CPUs handling a request in this context or waiting for
+	 * it, updated atomically before taking the lock and after releasing it
+	 */
+	unsigned int users;
+
+	/* Statistics, updated with the lock held */
+	uint64_t requests;
+	uint64_t contended;
 } secure_partition_context_t;
 
 uint64_t spm_secure_partition_enter(uint64_t *c_rt_ctx);
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/auxv.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lock_bench.h"
+
+/*
+ * This tool measures the spin, ticket and MCS locks of
+ * lib/locks/exclusive/aarch64/spinlock.S under contention. It must run on an
+ * AArch64 Linux system, for instance a QEMU virtual machine with many vCPUs.
+ * One thread is pinned to each CPU, and all the threads repeatedly take the
+ * same lock, update some data in the critical section, release it and do some
+ * work outside of it. For each lock type and for 1, 2, 4... threads, the tool
+ * prints the number of acquisitions per second, the fewest and the most
+ * acquisitions made by a thread, which show how fair the lock is, and the
+ * distribution of the time taken to acquire the lock. The data updated in the
+ * critical section also checks that the lock provides mutual exclusion.
+ */
+
+/* Size of the cache line used to separate the data of the threads */
+#define CACHE_LINE		128
+
+#define DEFAULT_DURATION_MS	1000
+#define DEFAULT_CS_WORK		16
+#define DEFAULT_NCS_WORK	256
+
+/* Number of acquisition times recorded by each thread */
+#define MAX_SAMPLES		65536
+
+/* ARMv8.1 atomic instructions, from <asm/hwcap.h> */
+#ifndef HWCAP_ATOMICS
+#define HWCAP_ATOMICS		(1 << 8)
+#endif
+
+typedef struct lock_impl {
+	const char *name;
+	int lse;
+	void (*lock)(void *lock, bench_mcs_node_t *node);
+	void (*unlock)(void *lock, bench_mcs_node_t *node);
+} lock_impl_t;
+
+/* Give all the lock functions the same prototype */
+#define DEFINE_LOCK_WRAPPERS(_p)					\
+static void _p##spin_lock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	(void)node;							\
+	_p##spin_lock(lock);						\
+}									\
+static void _p##spin_unlock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	(void)node;							\
+	_p##spin_unlock(lock);						\
+}									\
+static void _p##ticket_lock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	(void)node;							\
+	_p##ticket_lock(lock);						\
+}									\
+static void _p##ticket_unlock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	(void)node;							\
+	_p##ticket_unlock(lock);					\
+}									\
+static void _p##mcs_lock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	_p##mcs_lock(lock, node);					\
+}									\
+static void _p##mcs_unlock_w(void *lock, bench_mcs_node_t *node)	\
+{									\
+	_p##mcs_unlock(lock, node);					\
+}
+
+DEFINE_LOCK_WRAPPERS(fw_)
+DEFINE_LOCK_WRAPPERS(fw_lse_)
+
+#define LOCK_IMPL(_name, _p, _type, _lse)				\
+	{								\
+		.name = (_name),					\
+		.lse = (_lse),						\
+		.lock = _p##_type##_lock_w,				\
+		.unlock = _p##_type##_unlock_w,				\
+	}
+
+static const lock_impl_t impls[] = {
+	LOCK_IMPL("spin", fw_, spin, 0),
+	LOCK_IMPL("ticket", fw_, ticket, 0),
+	LOCK_IMPL("mcs", fw_, mcs, 0),
+	LOCK_IMPL("lse-spin", fw_lse_, spin, 1),
+	LOCK_IMPL("lse-ticket", fw_lse_, ticket, 1),
+	LOCK_IMPL("lse-mcs", fw_lse_, mcs, 1),
+};
+
+#define ARRAY_LEN(a)		(sizeof(a) / sizeof((a)[0]))
+
+typedef struct bench_thread {
+	pthread_t thread;
+	int cpu;
+	bench_mcs_node_t node;
+	unsigned long long acquired;
+	uint64_t *samples;
+	unsigned int num_samples;
+} __attribute__((aligned(CACHE_LINE))) bench_thread_t;
+
+/* The lock, which is either a 32-bit word or the tail of an MCS queue */
+static union {
+	volatile uint32_t word;
+	bench_mcs_node_t *volatile tail;
+} bench_lock __attribute__((aligned(CACHE_LINE)));
+
+/* Data updated in the critical section, in its own cache line */
+static struct {
+	volatile unsigned long long count;
+	volatile uint64_t data[DEFAULT_CS_WORK];
+} protected __attribute__((aligned(CACHE_LINE)));
+
+static const lock_impl_t *cur_impl;
+static unsigned int cs_work = DEFAULT_CS_WORK;
+static unsigned int ncs_work = DEFAULT_NCS_WORK;
+static volatile int stop;
+static pthread_barrier_t start_barrier;
+
+static inline uint64_t read_cntvct(void)
+{
+	uint64_t val;
+
+	__asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r" (val) : : "memory");
+	return val;
+}
+
+static inline uint64_t read_cntfrq(void)
+{
+	uint64_t val;
+
+	__asm__ volatile("mrs %0, cntfrq_el0" : "=r" (val));
+	return val;
+}
+
+/* Work that the compiler can't optimise away */
+static void spin_work(unsigned int iterations)
+{
+	for (unsigned int i = 0; i < iterations; i++)
+		__asm__ volatile("" : : : "memory");
+}
+
+static void *bench_thread_main(void *arg)
+{
+	bench_thread_t *t = arg;
+	unsigned int i;
+	uint64_t start;
+	unsigned long long count;
+
+	pthread_barrier_wait(&start_barrier);
+
+	while (stop == 0) {
+		start = read_cntvct();
+		cur_impl->lock(&bench_lock, &t->node);
+		if (t->num_samples < MAX_SAMPLES)
+			t->samples[t->num_samples++] = read_cntvct() - start;
+
+		/*
+		 * Read the count at the start of the critical section and
+		 * write it back at the end, so that a lock that doesn't
+		 * provide mutual exclusion loses increments.
+		 */
+		count = protected.count;
+		for (i = 0; i < cs_work; i++)
+			protected.data[i % DEFAULT_CS_WORK] += count;
+		protected.count = count + 1;
+
+		cur_impl->unlock(&bench_lock, &t->node);
+		t->acquired++;
+
+		spin_work(ncs_work);
+	}
+
+	return NULL;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Convert counter ticks to nanoseconds */
+static unsigned long long ticks_to_ns(uint64_t ticks)
+{
+	return (unsigned long long)ticks * 1000000000ULL / read_cntfrq();
+}
+
+/*
+ * Run the benchmark for a lock type with 'num_threads' threads, pinned to the
+ * first CPUs of 'cpus'. Returns 0 on success, or -1 if the lock failed to
+ * provide mutual exclusion.
+ */
+static int bench(const lock_impl_t *impl, bench_thread_t *threads,
+		 unsigned int num_threads, const int *cpus,
+		 unsigned int duration_ms)
+{
+	struct timespec delay = {
+		.tv_sec = duration_ms / 1000,
+		.tv_nsec = (duration_ms % 1000) * 1000000L,
+	};
+	unsigned long long total = 0, min_acq = ~0ULL, max_acq = 0;
+	unsigned int num_samples = 0;
+	uint64_t *samples;
+	pthread_attr_t attr;
+	cpu_set_t set;
+	unsigned int i;
+
+	memset((void *)&bench_lock, 0, sizeof(bench_lock));
+	memset((void *)&protected, 0, sizeof(protected));
+	cur_impl = impl;
+	stop = 0;
+
+	if (pthread_barrier_init(&start_barrier, NULL, num_threads + 1) != 0) {
+		perror("pthread_barrier_init");
+		exit(1);
+	}
+
+	for (i = 0; i < num_threads; i++) {
+		bench_thread_t *t = &threads[i];
+
+		t->cpu = cpus[i];
+		t->acquired = 0;
+		t->num_samples = 0;
+
+		CPU_ZERO(&set);
+		CPU_SET(t->cpu, &set);
+		if ((pthread_attr_init(&attr) != 0) ||
+		    (pthread_attr_setaffinity_np(&attr, sizeof(set), &set) != 0) ||
+		    (pthread_create(&t->thread, &attr, bench_thread_main, t) != 0)) {
+			fprintf(stderr, "Failed to start a thread on CPU %d\n",
+				t->cpu);
+			exit(1);
+		}
+		pthread_attr_destroy(&attr);
+	}
+
+	pthread_barrier_wait(&start_barrier);
+	nanosleep(&delay, NULL);
+	stop = 1;
+
+	for (i = 0; i < num_threads; i++)
+		pthread_join(threads[i].thread, NULL);
+
+	pthread_barrier_destroy(&start_barrier);
+
+	samples = malloc(sizeof(*samples) * MAX_SAMPLES * num_threads);
+	if (samples == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+
+	for (i = 0; i < num_threads; i++) {
+		bench_thread_t *t = &threads[i];
+
+		total += t->acquired;
+		if (t->acquired < min_acq)
+			min_acq = t->acquired;
+		if (t->acquired > max_acq)
+			max_acq = t->acquired;
+
+		memcpy(&samples[num_samples], t->samples,
+		       sizeof(*samples) * t->num_samples);
+		num_samples += t->num_samples;
+	}
+
+	if (num_samples == 0) {
+		printf("%-10s %7u no acquisitions\n", impl->name, num_threads);
+		free(samples);
+		return 0;
+	}
+
+	qsort(samples, num_samples, sizeof(*samples), compare_u64);
+
+	printf("%-10s %7u %12llu %12llu %12llu %8llu %8llu %8llu %10llu\n",
+	       impl->name, num_threads,
+	       total * 1000ULL / duration_ms, min_acq, max_acq,
+	       ticks_to_ns(samples[0]),
+	       ticks_to_ns(samples[num_samples / 2]),
+	       ticks_to_ns(samples[(num_samples * 99ULL) / 100]),
+	       ticks_to_ns(samples[num_samples - 1]));
+
+	free(samples);
+
+	if (protected.count != total) {
+		fprintf(stderr,
+			"ERROR: %s: %llu acquisitions but the count is %llu\n",
+			impl->name, total, protected.count);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: lock_bench [-t <threads>] [-d <ms>] [-c <work>] [-n <work>]\n"
+		"                  [-l <lock>]\n\n"
+		"  -c  Iterations of work in the critical section (default %u)\n"
+		"  -d  Duration of each measurement in ms (default %u)\n"
+		"  -l  Only measure this lock type: spin, ticket, mcs, or the\n"
+		"      same prefixed with lse- for the ARMv8.1 implementations\n"
+		"  -n  Iterations of work outside of the critical section\n"
+		"      (default %u)\n"
+		"  -t  Maximum number of threads (default: number of CPUs)\n",
+		DEFAULT_CS_WORK, DEFAULT_DURATION_MS, DEFAULT_NCS_WORK);
+	exit(1);
+}
+
+static unsigned int parse_uint(const char *str)
+{
+	char *end;
+	unsigned long val = strtoul(str, &end, 0);
+
+	if ((*str == '\0') || (*end != '\0') || (val > UINT32_MAX))
+		usage();
+
+	return (unsigned int)val;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int duration_ms = DEFAULT_DURATION_MS;
+	unsigned int max_threads = 0, num_cpus = 0, n, i;
+	const char *only = NULL;
+	bench_thread_t *threads;
+	cpu_set_t set;
+	int *cpus;
+	int lse = (getauxval(AT_HWCAP) & HWCAP_ATOMICS) != 0;
+	int failed = 0, found = 0;
+	int c;
+
+	while ((c = getopt(argc, argv, "c:d:l:n:t:h")) != -1) {
+		switch (c) {
+		case 'c':
+			cs_work = parse_uint(optarg);
+			break;
+		case 'd':
+			duration_ms = parse_uint(optarg);
+			if (duration_ms == 0)
+				usage();
+			break;
+		case 'l':
+			only = optarg;
+			break;
+		case 'n':
+			ncs_work = parse_uint(optarg);
+			break;
+		case 't':
+			max_threads = parse_uint(optarg);
+			if (max_threads == 0)
+				usage();
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	/* Run the threads on the CPUs the tool is allowed to use */
+	if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+		perror("sched_getaffinity");
+		return 1;
+	}
+
+	cpus = malloc(sizeof(*cpus) * CPU_SETSIZE);
+	if (cpus == NULL) {
+		perror("malloc");
+		return 1;
+	}
+
+	for (i = 0; i < CPU_SETSIZE; i++) {
+		if (CPU_ISSET(i, &set))
+			cpus[num_cpus++] = i;
+	}
+
+	if (max_threads == 0)
+		max_threads = num_cpus;
+
+	if (max_threads > num_cpus) {
+		fprintf(stderr, "Only %u CPUs are available\n", num_cpus);
+		return 1;
+	}
+
+	threads = aligned_alloc(CACHE_LINE, sizeof(*threads) * max_threads);
+	if (threads == NULL) {
+		perror("aligned_alloc");
+		return 1;
+	}
+
+	for (i = 0; i < max_threads; i++) {
+		threads[i].samples = malloc(sizeof(uint64_t) * MAX_SAMPLES);
+		if (threads[i].samples == NULL) {
+			perror("malloc");
+			return 1;
+		}
+	}
+
+	printf("Critical section: %u, outside: %u, %u ms per measurement\n",
+	       cs_work, ncs_work, duration_ms);
+	if (lse == 0)
+		printf("The CPU doesn't implement the ARMv8.1 atomic instructions, skipping the lse- locks\n");
+	printf("\n%-10s %7s %12s %12s %12s %8s %8s %8s %10s\n",
+	       "lock", "threads", "acq/s", "min/thread", "max/thread",
+	       "min ns", "median", "p99", "max");
+
+	for (i = 0; i < ARRAY_LEN(impls); i++) {
+		if ((only != NULL) && (strcmp(only, impls[i].name) != 0))
+			continue;
+
+		found = 1;
+		if ((impls[i].lse != 0) && (lse == 0))
+			continue;
+
+		/* 1, 2, 4... threads, and the maximum */
+		for (n = 1; ; n *= 2) {
+			if (n > max_threads)
+				n = max_threads;
+
+			if (bench(&impls[i], threads, n, cpus, duration_ms) != 0)
+				failed = 1;
+
+			if (n == max_threads)
+				break;
+		}
+	}
+
+	if (found == 0)
+		usage();
+
+	return failed;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __LOCK_BENCH_H__
+#define __LOCK_BENCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Host definitions of the lock types of include/lib/spinlock.h. Spin locks and
+ * ticket locks are a 32-bit word, and MCS lock queue nodes must have the
+ * layout given by MCS_NODE_NEXT and MCS_NODE_LOCKED.
+ */
+typedef struct bench_mcs_node {
+	struct bench_mcs_node *volatile next;
+	volatile uint32_t locked;
+} bench_mcs_node_t;
+
+_Static_assert(offsetof(bench_mcs_node_t, next) == 0,
+	       "MCS_NODE_NEXT mismatch");
+_Static_assert(offsetof(bench_mcs_node_t, locked) == 8,
+	       "MCS_NODE_LOCKED mismatch");
+
+/*
+ * lib/locks/exclusive/aarch64/spinlock.S is assembled twice, with its
+ * functions renamed: once for ARMv8.0 with exclusive pairs (fw_ prefix) and
+ * once for ARMv8.1 with the LSE atomic instructions (fw_lse_ prefix).
+ */
+void fw_spin_lock(volatile uint32_t *lock);
+void fw_spin_unlock(volatile uint32_t *lock);
+void fw_ticket_lock(volatile uint32_t *lock);
+void fw_ticket_unlock(volatile uint32_t *lock);
+void fw_mcs_lock(bench_mcs_node_t *volatile *lock, bench_mcs_node_t *node);
+void fw_mcs_unlock(bench_mcs_node_t *volatile *lock, bench_mcs_node_t *node);
+
+void fw_lse_spin_lock(volatile uint32_t *lock);
+void fw_lse_spin_unlock(volatile uint32_t *lock);
+void fw_lse_ticket_lock(volatile uint32_t *lock);
+void fw_lse_ticket_unlock(volatile uint32_t *lock);
+void fw_lse_mcs_lock(bench_mcs_node_t *volatile *lock, bench_mcs_node_t *node);
+void fw_lse_mcs_unlock(bench_mcs_node_t *volatile *lock,
+		       bench_mcs_node_t *node);
+
+#endif /* __LOCK_BENCH_H__ */
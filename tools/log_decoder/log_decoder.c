@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <elf.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * This tool turns the binary log records output by images built with
+ * ENABLE_BINARY_LOG=1 back into text. The record layout is described in
+ * include/common/debug.h. Text output by the images, e.g. by tf_printf(), is
+ * copied as is.
+ */
+
+/* Definitions shared with include/common/debug.h */
+#define TF_BLOG_MARKER		0xfe
+#define TF_BLOG_FMT_SECTION	".tf_log_fmt"
+#define TF_BLOG_MAX_ARGS	9
+
+#define MAX_IMAGES		8
+#define MAX_SECTIONS		64
+
+/* Loaded section of an image, used to resolve the arguments of "%s" */
+typedef struct section {
+	uint64_t addr;
+	uint64_t size;
+	const char *data;
+} section_t;
+
+typedef struct image {
+	const char *filename;
+	char *elf;
+	size_t elf_size;
+	unsigned int id;
+	const char *fmt;
+	uint64_t fmt_size;
+	section_t sections[MAX_SECTIONS];
+	unsigned int num_sections;
+} image_t;
+
+typedef struct log_arg {
+	uint64_t value;
+	unsigned int size;
+} log_arg_t;
+
+static image_t images[MAX_IMAGES];
+static unsigned int num_images;
+
+/* Set if the console did not turn "\n" into "\r\n" in the captured stream */
+static int raw_stream;
+
+static FILE *in;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: log_decoder [-r] -e <elf file> [-e <elf file>...] "
+		"[<log file>]\n\n"
+		"  -e  ELF file of an image that output binary log records\n"
+		"  -r  The log was not captured through a console, e.g. it was\n"
+		"      dumped from memory\n\n"
+		"The log is read from the standard input if no file is given.\n");
+	exit(1);
+}
+
+static void __attribute__((noreturn)) fatal(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	exit(1);
+}
+
+/* Read a field of an ELF structure, which may be 32 or 64 bits wide */
+#define ELF_FIELD(is64, ptr, type, field)				\
+	((is64) ? ((const Elf64_##type *)(ptr))->field :		\
+		  ((const Elf32_##type *)(ptr))->field)
+
+static void load_image(image_t *image, const char *filename)
+{
+	FILE *fp;
+	long size;
+	const char *ehdr, *shdr, *shstrtab;
+	uint64_t shoff, sh_offset, sh_size, sh_flags;
+	unsigned int i, shnum, shentsize, shstrndx, sh_type, is64;
+	const char *name;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		fatal("Cannot open %s: %s\n", filename, strerror(errno));
+
+	if ((fseek(fp, 0, SEEK_END) != 0) || ((size = ftell(fp)) < 0) ||
+	    (fseek(fp, 0, SEEK_SET) != 0))
+		fatal("Cannot get the size of %s\n", filename);
+
+	image->filename = filename;
+	image->elf_size = size;
+	image->elf = malloc(size);
+	if (image->elf == NULL)
+		fatal("Out of memory\n");
+
+	if (fread(image->elf, 1, size, fp) != (size_t)size)
+		fatal("Cannot read %s\n", filename);
+	fclose(fp);
+
+	ehdr = image->elf;
+	if ((image->elf_size < EI_NIDENT) ||
+	    (memcmp(ehdr, ELFMAG, SELFMAG) != 0))
+		fatal("%s is not an ELF file\n", filename);
+
+	if (ehdr[EI_DATA] != ELFDATA2LSB)
+		fatal("%s is not a little-endian ELF file\n", filename);
+
+	is64 = (ehdr[EI_CLASS] == ELFCLASS64);
+	if ((image->elf_size < (is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr))))
+		fatal("%s is truncated\n", filename);
+
+	shoff = ELF_FIELD(is64, ehdr, Ehdr, e_shoff);
+	shnum = ELF_FIELD(is64, ehdr, Ehdr, e_shnum);
+	shentsize = ELF_FIELD(is64, ehdr, Ehdr, e_shentsize);
+	shstrndx = ELF_FIELD(is64, ehdr, Ehdr, e_shstrndx);
+
+	if ((shstrndx >= shnum) ||
+	    (shoff + (uint64_t)shnum * shentsize > image->elf_size))
+		fatal("%s has an invalid section header table\n", filename);
+
+	shdr = image->elf + shoff + (uint64_t)shstrndx * shentsize;
+	shstrtab = image->elf + ELF_FIELD(is64, shdr, Shdr, sh_offset);
+
+	for (i = 0; i < shnum; i++) {
+		shdr = image->elf + shoff + (uint64_t)i * shentsize;
+		name = shstrtab + ELF_FIELD(is64, shdr, Shdr, sh_name);
+		sh_type = ELF_FIELD(is64, shdr, Shdr, sh_type);
+		sh_flags = ELF_FIELD(is64, shdr, Shdr, sh_flags);
+		sh_offset = ELF_FIELD(is64, shdr, Shdr, sh_offset);
+		sh_size = ELF_FIELD(is64, shdr, Shdr, sh_size);
+
+		if ((sh_type == SHT_NOBITS) || (sh_size == 0))
+			continue;
+
+		if (sh_offset + sh_size > image->elf_size)
+			fatal("%s has an invalid section %s\n", filename, name);
+
+		if (strcmp(name, TF_BLOG_FMT_SECTION) == 0) {
+			image->fmt = image->elf + sh_offset;
+			image->fmt_size = sh_size;
+		} else if ((sh_flags & SHF_ALLOC) &&
+			   (image->num_sections < MAX_SECTIONS)) {
+			section_t *sec = &image->sections[image->num_sections++];
+
+			sec->addr = ELF_FIELD(is64, shdr, Shdr, sh_addr);
+			sec->size = sh_size;
+			sec->data = image->elf + sh_offset;
+		}
+	}
+
+	if (image->fmt == NULL)
+		fatal("%s was not built with ENABLE_BINARY_LOG=1\n", filename);
+
+	/* The first byte of the section identifies the image */
+	image->id = (unsigned char)image->fmt[0];
+}
+
+static const image_t *find_image(unsigned int id)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_images; i++) {
+		if (images[i].id == id)
+			return &images[i];
+	}
+
+	return NULL;
+}
+
+/*
+ * Read a byte of a record. Unless the stream is raw, the console output "\r"
+ * before each "\n", so a "\r" followed by "\n" is dropped.
+ */
+static int read_record_byte(void)
+{
+	int c = getc(in), next;
+
+	if ((c == '\r') && !raw_stream) {
+		next = getc(in);
+		if (next == '\n')
+			return next;
+		if (next != EOF)
+			ungetc(next, in);
+	}
+
+	return c;
+}
+
+static const char *level_prefix(unsigned int level)
+{
+	static const char *prefix_str[] = {
+		"ERROR:   ", "NOTICE:  ", "WARNING: ", "INFO:    ", "VERBOSE: "};
+
+	if ((level == 0) || (level > 50) || ((level % 10) != 0))
+		return NULL;
+
+	return prefix_str[(level / 10) - 1];
+}
+
+/* Print a number the same way as unsigned_num_print() in tf_printf.c */
+static void print_unsigned(uint64_t unum, unsigned int radix, char padc,
+			   int padn)
+{
+	char num_buf[20];
+	int i = 0;
+	unsigned int rem;
+
+	do {
+		rem = unum % radix;
+		if (rem < 0xa)
+			num_buf[i] = '0' + rem;
+		else
+			num_buf[i] = 'a' + (rem - 0xa);
+		i++;
+		unum /= radix;
+	} while (unum > 0);
+
+	if (padn > 0) {
+		while (i < padn--)
+			putchar(padc);
+	}
+
+	while (--i >= 0)
+		putchar(num_buf[i]);
+}
+
+/* Print the string at address 'addr' in the memory of the image */
+static void print_string(const image_t *image, uint64_t addr)
+{
+	const section_t *sec;
+	uint64_t off;
+	unsigned int i;
+
+	for (i = 0; i < image->num_sections; i++) {
+		sec = &image->sections[i];
+		if ((addr < sec->addr) || (addr - sec->addr >= sec->size))
+			continue;
+
+		for (off = addr - sec->addr;
+		     (off < sec->size) && (sec->data[off] != '\0'); off++)
+			putchar(sec->data[off]);
+		return;
+	}
+
+	/* The string was built at runtime */
+	printf("<string at 0x%llx>", (unsigned long long)addr);
+}
+
+/*
+ * Print a message the same way as tf_vprintf() in tf_printf.c, taking the
+ * arguments from the record.
+ */
+static void print_message(const image_t *image, const char *fmt,
+			  const log_arg_t *args, unsigned int nargs)
+{
+	const log_arg_t *arg;
+	unsigned int next_arg = 0;
+	uint64_t unum;
+	char padc;
+	int padn;
+
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			putchar(*fmt++);
+			continue;
+		}
+
+		padc = ' ';
+		padn = 0;
+
+		/* Skip the flags and length modifiers, the size is recorded */
+		for (fmt++; ; fmt++) {
+			if (*fmt == '0') {
+				padc = '0';
+			} else if ((*fmt >= '1') && (*fmt <= '9')) {
+				padn = 0;
+				while ((*fmt >= '0') && (*fmt <= '9'))
+					padn = (padn * 10) + (*fmt++ - '0');
+				fmt--;
+			} else if ((*fmt != 'l') && (*fmt != 'z')) {
+				break;
+			}
+		}
+
+		if (*fmt == '\0')
+			break;
+
+		if (next_arg == nargs) {
+			printf("<missing argument>");
+			fmt++;
+			continue;
+		}
+
+		arg = &args[next_arg++];
+		unum = arg->value;
+
+		switch (*fmt) {
+		case 'i':
+		case 'd':
+			/* Sign-extend the argument from its recorded size */
+			if ((arg->size < 8) &&
+			    (unum & (1ULL << ((arg->size * 8) - 1))))
+				unum |= ~0ULL << (arg->size * 8);
+
+			if ((int64_t)unum < 0) {
+				putchar('-');
+				unum = -unum;
+				padn--;
+			}
+			print_unsigned(unum, 10, padc, padn);
+			break;
+		case 's':
+			print_string(image, unum);
+			break;
+		case 'p':
+			if (unum != 0) {
+				printf("0x");
+				padn -= 2;
+			}
+			print_unsigned(unum, 16, padc, padn);
+			break;
+		case 'x':
+			print_unsigned(unum, 16, padc, padn);
+			break;
+		case 'u':
+			print_unsigned(unum, 10, padc, padn);
+			break;
+		default:
+			/* Exit on any other format specifier */
+			return;
+		}
+		fmt++;
+	}
+}
+
+/*
+ * Decode a record, once its marker has been read. Return 0 on success, or -1
+ * if the record is malformed or truncated.
+ */
+static int decode_record(void)
+{
+	log_arg_t args[TF_BLOG_MAX_ARGS];
+	const image_t *image;
+	const char *prefix;
+	uint32_t fmt_id = 0;
+	unsigned int i, j, nargs;
+	int c, id, level;
+
+	id = read_record_byte();
+	level = read_record_byte();
+	if ((id == EOF) || (level == EOF))
+		return -1;
+
+	image = find_image(id);
+	prefix = level_prefix(level);
+	if ((image == NULL) || (prefix == NULL))
+		return -1;
+
+	for (i = 0; i < 4; i++) {
+		c = read_record_byte();
+		if (c == EOF)
+			return -1;
+		fmt_id |= (uint32_t)c << (i * 8);
+	}
+
+	c = read_record_byte();
+	if ((c == EOF) || (c > TF_BLOG_MAX_ARGS))
+		return -1;
+	nargs = c;
+
+	for (i = 0; i < nargs; i++) {
+		c = read_record_byte();
+		if ((c == EOF) || (c == 0) || (c > 8))
+			return -1;
+
+		args[i].size = c;
+		args[i].value = 0;
+		for (j = 0; j < args[i].size; j++) {
+			c = read_record_byte();
+			if (c == EOF)
+				return -1;
+			args[i].value |= (uint64_t)c << (j * 8);
+		}
+	}
+
+	/* The format string must be NUL-terminated within the section */
+	if ((fmt_id == 0) || (fmt_id >= image->fmt_size) ||
+	    (memchr(image->fmt + fmt_id, '\0',
+		    image->fmt_size - fmt_id) == NULL))
+		return -1;
+
+	printf("%s", prefix);
+	print_message(image, image->fmt + fmt_id, args, nargs);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int c;
+
+	while ((c = getopt(argc, argv, "e:rh")) != -1) {
+		switch (c) {
+		case 'e':
+			if (num_images == MAX_IMAGES)
+				fatal("Too many ELF files\n");
+			load_image(&images[num_images], optarg);
+			if (find_image(images[num_images].id) != NULL)
+				fatal("%s has the same identifier as another "
+				      "image\n", optarg);
+			num_images++;
+			break;
+		case 'r':
+			raw_stream = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if ((num_images == 0) || (argc - optind > 1))
+		usage();
+
+	if (optind < argc) {
+		in = fopen(argv[optind], "rb");
+		if (in == NULL)
+			fatal("Cannot open %s: %s\n", argv[optind],
+			      strerror(errno));
+	} else {
+		in = stdin;
+	}
+
+	while ((c = getc(in)) != EOF) {
+		if (c != TF_BLOG_MARKER) {
+			putchar(c);
+			continue;
+		}
+
+		/*
+		 * The records of different CPUs may be interleaved, in which
+		 * case the rest of the corrupted record is output as text.
+		 */
+		if (decode_record() != 0)
+			fprintf(stderr, "WARNING: Malformed log record\n");
+
+		fflush(stdout);
+	}
+
+	if (in != stdin)
+		fclose(in);
+
+	return 0;
+}
@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mem_bench.h"
+
+/*
+ * This tool runs the memset(), memcmp(), memcpy(), memmove() and memchr()
+ * implementations of lib/stdlib on the host. It first checks them against the
+ * host C library for every combination of buffer alignments and for all short
+ * lengths, which covers the unaligned heads and tails of the word loops, then
+ * measures their throughput. Both the default implementations and the ones
+ * selected by USE_SMALL_MEM_FUNCS are checked and measured.
+ */
+
+/* Alignments tested: every offset within two words */
+#define MAX_OFFSET		(2 * sizeof(uintptr_t))
+
+/* All the lengths up to this one are tested, then a few larger ones */
+#define MAX_SHORT_LEN		160
+
+/* Bytes around the destination that must not be modified */
+#define GUARD			32
+
+#define BUF_SIZE		8192
+
+/* Number of errors that are described */
+#define MAX_REPORTED_ERRORS	20
+
+/* Default amount of data processed by each throughput measurement */
+#define DEFAULT_BENCH_MIB	256
+
+typedef struct mem_impl {
+	const char *name;
+	void *(*memset)(void *dst, int val, size_t count);
+	int (*memcmp)(const void *s1, const void *s2, size_t len);
+	void *(*memcpy)(void *dst, const void *src, size_t len);
+	void *(*memmove)(void *dst, const void *src, size_t len);
+	void *(*memchr)(const void *src, int c, size_t len);
+} mem_impl_t;
+
+/* The implementations that are checked, then the host C library */
+static const mem_impl_t impls[] = {
+	{
+		.name = "word",
+		.memset = fw_memset,
+		.memcmp = fw_memcmp,
+		.memcpy = fw_memcpy,
+		.memmove = fw_memmove,
+		.memchr = fw_memchr,
+	},
+	{
+		.name = "small",
+		.memset = fw_small_memset,
+		.memcmp = fw_small_memcmp,
+		.memcpy = fw_small_memcpy,
+		.memmove = fw_small_memmove,
+		.memchr = fw_small_memchr,
+	},
+	{
+		.name = "host",
+		.memset = memset,
+		.memcmp = memcmp,
+		.memcpy = memcpy,
+		.memmove = memmove,
+		.memchr = memchr,
+	},
+};
+
+#define ARRAY_LEN(a)		(sizeof(a) / sizeof((a)[0]))
+
+#define NUM_CHECKED_IMPLS	2
+#define NUM_IMPLS		ARRAY_LEN(impls)
+
+static const size_t long_lens[] = {
+	255, 256, 257, 1023, 1024, 1025, 4095, 4096, 4097
+};
+
+#define NUM_LENS		(MAX_SHORT_LEN + 1 + ARRAY_LEN(long_lens))
+
+static unsigned char buf_a[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char buf_b[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char buf_ref[BUF_SIZE] __attribute__((aligned(64)));
+
+static unsigned int errors;
+static uint32_t rand_state = 1;
+static volatile uintptr_t sink;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: mem_bench [-t] [-m <MiB>]\n\n"
+		"  -m  Amount of data processed by each throughput measurement,\n"
+		"      in MiB (default %u)\n"
+		"  -t  Only check the implementations, don't measure them\n",
+		DEFAULT_BENCH_MIB);
+	exit(1);
+}
+
+/* Returns the length tested at index 'i', in [0, NUM_LENS) */
+static size_t test_len(unsigned int i)
+{
+	if (i <= MAX_SHORT_LEN)
+		return i;
+
+	return long_lens[i - MAX_SHORT_LEN - 1];
+}
+
+/*
+ * Size of the part of the buffers used to test length 'len'. It is not
+ * inlined, as GCC would otherwise warn about lengths that can't happen.
+ */
+static size_t __attribute__((noinline)) test_span(size_t len)
+{
+	return GUARD + 2 * MAX_OFFSET + len + GUARD;
+}
+
+static void fill_random(unsigned char *buf, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		/* xorshift32 */
+		rand_state ^= rand_state << 13;
+		rand_state ^= rand_state >> 17;
+		rand_state ^= rand_state << 5;
+		buf[i] = rand_state;
+	}
+}
+
+static void error(const mem_impl_t *impl, const char *func,
+		  const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static void error(const mem_impl_t *impl, const char *func,
+		  const char *fmt, ...)
+{
+	va_list args;
+
+	if (errors++ >= MAX_REPORTED_ERRORS)
+		return;
+
+	fprintf(stderr, "ERROR: %s %s: ", impl->name, func);
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+/*******************************************************************************
+ * Correctness checks. The buffers are filled with random data, the function is
+ * called on a range inside them and the whole span, including the guard bytes,
+ * is compared to the result of the host C library.
+ ******************************************************************************/
+static void check_memset(const mem_impl_t *impl)
+{
+	static const int vals[] = { 0, 0x5a, 0xff, 0x1a5, -1 };
+
+	for (unsigned int off = 0; off < MAX_OFFSET; off++) {
+		for (unsigned int i = 0; i < NUM_LENS; i++) {
+			size_t len = test_len(i);
+			size_t span = test_span(len);
+
+			for (unsigned int v = 0; v < ARRAY_LEN(vals); v++) {
+				unsigned char *dst = buf_a + GUARD + off;
+				void *ret;
+
+				fill_random(buf_a, span);
+				memcpy(buf_ref, buf_a, span);
+				memset(buf_ref + GUARD + off, vals[v], len);
+
+				ret = impl->memset(dst, vals[v], len);
+				if ((ret != dst) ||
+				    (memcmp(buf_a, buf_ref, span) != 0))
+					error(impl, "memset",
+					      "off=%u len=%zu val=%#x",
+					      off, len, vals[v]);
+			}
+		}
+	}
+}
+
+static void check_memcpy(const mem_impl_t *impl)
+{
+	for (unsigned int doff = 0; doff < MAX_OFFSET; doff++) {
+		for (unsigned int soff = 0; soff < MAX_OFFSET; soff++) {
+			for (unsigned int i = 0; i < NUM_LENS; i++) {
+				size_t len = test_len(i);
+				size_t span = test_span(len);
+				unsigned char *dst = buf_a + GUARD + doff;
+				unsigned char *src = buf_b + GUARD + soff;
+				void *ret;
+
+				fill_random(buf_a, span);
+				fill_random(buf_b, span);
+				memcpy(buf_ref, buf_a, span);
+				memcpy(buf_ref + GUARD + doff, src, len);
+
+				ret = impl->memcpy(dst, src, len);
+				if ((ret != dst) ||
+				    (memcmp(buf_a, buf_ref, span) != 0))
+					error(impl, "memcpy",
+					      "dst_off=%u src_off=%u len=%zu",
+					      doff, soff, len);
+			}
+		}
+	}
+}
+
+/*
+ * The source and destination are in the same buffer, at most 2 * MAX_OFFSET
+ * bytes apart, so they overlap in both directions for all but the shortest
+ * lengths.
+ */
+static void check_memmove(const mem_impl_t *impl)
+{
+	for (unsigned int dpos = 0; dpos < 2 * MAX_OFFSET; dpos++) {
+		for (unsigned int spos = 0; spos < 2 * MAX_OFFSET; spos++) {
+			for (unsigned int i = 0; i < NUM_LENS; i++) {
+				size_t len = test_len(i);
+				size_t span = test_span(len);
+				unsigned char *dst = buf_a + GUARD + dpos;
+				unsigned char *src = buf_a + GUARD + spos;
+				void *ret;
+
+				fill_random(buf_a, span);
+				memcpy(buf_ref, buf_a, span);
+				memmove(buf_ref + GUARD + dpos,
+					buf_ref + GUARD + spos, len);
+
+				ret = impl->memmove(dst, src, len);
+				if ((ret != dst) ||
+				    (memcmp(buf_a, buf_ref, span) != 0))
+					error(impl, "memmove",
+					      "dst_pos=%u src_pos=%u len=%zu",
+					      dpos, spos, len);
+			}
+		}
+	}
+}
+
+static int sign(int val)
+{
+	return (val > 0) - (val < 0);
+}
+
+static void check_memcmp_one(const mem_impl_t *impl, const unsigned char *s1,
+			     const unsigned char *s2, size_t len,
+			     unsigned int off1, unsigned int off2, size_t diff)
+{
+	int expected = sign(memcmp(s1, s2, len));
+	int ret = sign(impl->memcmp(s1, s2, len));
+
+	if (ret != expected)
+		error(impl, "memcmp",
+		      "off1=%u off2=%u len=%zu diff=%zu: %d instead of %d",
+		      off1, off2, len, diff, ret, expected);
+}
+
+/*
+ * Each pair of buffers is compared when equal, then with a difference at the
+ * start, in the middle and at the end, in both directions, and with a
+ * difference just after the end that must be ignored. The differing bytes
+ * straddle 0x80 to check that they are compared as unsigned char.
+ */
+static void check_memcmp(const mem_impl_t *impl)
+{
+	for (unsigned int off1 = 0; off1 < MAX_OFFSET; off1++) {
+		for (unsigned int off2 = 0; off2 < MAX_OFFSET; off2++) {
+			for (unsigned int i = 0; i < NUM_LENS; i++) {
+				size_t len = test_len(i);
+				unsigned char *s1 = buf_a + GUARD + off1;
+				unsigned char *s2 = buf_b + GUARD + off2;
+				size_t diffs[] = { 0, len / 2, len - 1 };
+
+				fill_random(s1, len + 1);
+				memcpy(s2, s1, len + 1);
+				s2[len] = s1[len] + 1;
+				check_memcmp_one(impl, s1, s2, len,
+						 off1, off2, len);
+
+				for (unsigned int d = 0;
+				     (len != 0) && (d < ARRAY_LEN(diffs));
+				     d++) {
+					size_t diff = diffs[d];
+					unsigned char saved1 = s1[diff];
+					unsigned char saved2 = s2[diff];
+
+					s1[diff] = 0x80;
+					s2[diff] = 0x7f;
+					check_memcmp_one(impl, s1, s2, len,
+							 off1, off2, diff);
+					check_memcmp_one(impl, s2, s1, len,
+							 off2, off1, diff);
+					s1[diff] = saved1;
+					s2[diff] = saved2;
+				}
+			}
+		}
+	}
+}
+
+/*
+ * The byte looked for is placed at the start, in the middle, at the end or
+ * just after the end of the buffer, or nowhere. It is also looked for with
+ * values of 'c' that are only equal to it once converted to unsigned char.
+ */
+static void check_memchr(const mem_impl_t *impl)
+{
+	static const int vals[] = { 0xa5, 0x1a5, -0x5b };
+	const unsigned char byte = 0xa5;
+
+	for (unsigned int off = 0; off < MAX_OFFSET; off++) {
+		for (unsigned int i = 0; i < NUM_LENS; i++) {
+			size_t len = test_len(i);
+			size_t span = test_span(len);
+			unsigned char *src = buf_a + GUARD + off;
+			size_t positions[] = { 0, len / 2, len - 1, len,
+					       SIZE_MAX };
+
+			for (unsigned int p = 0; p < ARRAY_LEN(positions);
+			     p++) {
+				size_t pos = positions[p];
+				void *expected;
+
+				if ((len == 0) && (pos != len) &&
+				    (pos != SIZE_MAX))
+					continue;
+
+				fill_random(buf_a, span);
+				for (size_t j = 0; j < span; j++) {
+					if (buf_a[j] == byte)
+						buf_a[j] = (unsigned char)~byte;
+				}
+				if (pos != SIZE_MAX)
+					src[pos] = byte;
+				expected = (pos < len) ? &src[pos] : NULL;
+
+				for (unsigned int v = 0; v < ARRAY_LEN(vals);
+				     v++) {
+					void *ret = impl->memchr(src, vals[v],
+								 len);
+
+					if (ret != expected)
+						error(impl, "memchr",
+						      "off=%u len=%zu pos=%zd val=%#x",
+						      off, len, (ssize_t)pos,
+						      vals[v]);
+				}
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+ * Throughput measurements.
+ ******************************************************************************/
+#define BENCH_MAX_SIZE		(64 * 1024)
+
+static unsigned char bench_dst[BENCH_MAX_SIZE + 64] __attribute__((aligned(64)));
+static unsigned char bench_src[BENCH_MAX_SIZE + 64] __attribute__((aligned(64)));
+
+static const size_t bench_sizes[] = { 16, 64, 512, 4096, BENCH_MAX_SIZE };
+
+typedef enum bench_func {
+	BENCH_MEMSET,
+	BENCH_MEMCMP,
+	BENCH_MEMCPY,
+	BENCH_MEMMOVE,
+	BENCH_MEMCHR,
+	BENCH_NUM_FUNCS
+} bench_func_t;
+
+static const char *const bench_func_names[] = {
+	[BENCH_MEMSET] = "memset",
+	[BENCH_MEMCMP] = "memcmp",
+	[BENCH_MEMCPY] = "memcpy",
+	[BENCH_MEMMOVE] = "memmove",
+	[BENCH_MEMCHR] = "memchr",
+};
+
+/*
+ * Alignments measured: both buffers word aligned, both misaligned by the same
+ * amount (the head and tail are handled a byte at a time) and misaligned with
+ * each other (the whole buffer is handled a byte at a time). memset() only uses
+ * the destination and memchr() only the source.
+ */
+static const struct {
+	const char *name;
+	unsigned int dst_off;
+	unsigned int src_off;
+} bench_aligns[] = {
+	{ "aligned", 0, 0 },
+	{ "co-aligned", 3, 3 },
+	{ "misaligned", 0, 1 },
+};
+
+static unsigned long long time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Returns the throughput of 'func' in MiB/s */
+static double bench_one(const mem_impl_t *impl, bench_func_t func,
+			size_t size, unsigned int dst_off, unsigned int src_off,
+			unsigned long long total)
+{
+	unsigned char *dst = bench_dst + dst_off;
+	unsigned char *src = bench_src + src_off;
+	unsigned long long iters = total / size;
+	unsigned long long start, ns;
+	uintptr_t acc = 0;
+
+	/* Equal buffers without the byte looked for: the whole size is read */
+	memset(bench_src, 0x5a, sizeof(bench_src));
+	memset(bench_dst, 0x5a, sizeof(bench_dst));
+
+	start = time_ns();
+	for (unsigned long long i = 0; i < iters; i++) {
+		switch (func) {
+		case BENCH_MEMSET:
+			acc += (uintptr_t)impl->memset(dst, (int)i, size);
+			break;
+		case BENCH_MEMCMP:
+			acc += impl->memcmp(dst, src, size);
+			break;
+		case BENCH_MEMCPY:
+			acc += (uintptr_t)impl->memcpy(dst, src, size);
+			break;
+		case BENCH_MEMMOVE:
+			/* Overlapping, towards the higher addresses */
+			acc += (uintptr_t)impl->memmove(dst + 8,
+							bench_dst + src_off,
+							size - 8);
+			break;
+		default:
+			acc += (uintptr_t)impl->memchr(src, 0xa5, size);
+			break;
+		}
+	}
+	ns = time_ns() - start;
+	sink = acc;
+
+	if (ns == 0)
+		ns = 1;
+
+	return (double)iters * size * 1000000000.0 / ns / (1024 * 1024);
+}
+
+static void bench(unsigned long long total)
+{
+	printf("%-8s %6s %-11s", "function", "size", "alignment");
+	for (unsigned int i = 0; i < NUM_IMPLS; i++)
+		printf(" %9s", impls[i].name);
+	printf("   (MiB/s)\n");
+
+	for (unsigned int f = 0; f < BENCH_NUM_FUNCS; f++) {
+		for (unsigned int s = 0; s < ARRAY_LEN(bench_sizes); s++) {
+			for (unsigned int a = 0; a < ARRAY_LEN(bench_aligns);
+			     a++) {
+				printf("%-8s %6zu %-11s", bench_func_names[f],
+				       bench_sizes[s], bench_aligns[a].name);
+				for (unsigned int i = 0; i < NUM_IMPLS; i++)
+					printf(" %9.0f", bench_one(&impls[i],
+						f, bench_sizes[s],
+						bench_aligns[a].dst_off,
+						bench_aligns[a].src_off,
+						total));
+				printf("\n");
+			}
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long mib = DEFAULT_BENCH_MIB;
+	int check_only = 0;
+	char *end;
+	int c;
+
+	while ((c = getopt(argc, argv, "m:th")) != -1) {
+		switch (c) {
+		case 'm':
+			mib = strtoul(optarg, &end, 0);
+			if ((*optarg == '\0') || (*end != '\0') || (mib == 0))
+				usage();
+			break;
+		case 't':
+			check_only = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	for (unsigned int i = 0; i < NUM_CHECKED_IMPLS; i++) {
+		check_memset(&impls[i]);
+		check_memcpy(&impls[i]);
+		check_memmove(&impls[i]);
+		check_memcmp(&impls[i]);
+		check_memchr(&impls[i]);
+	}
+
+	if (errors != 0) {
+		fprintf(stderr, "ERROR: %u errors\n", errors);
+		return 1;
+	}
+
+	printf("All the checks passed\n");
+
+	if (check_only == 0) {
+		printf("\n");
+		bench((unsigned long long)mib * 1024 * 1024);
+	}
+
+	return 0;
+}
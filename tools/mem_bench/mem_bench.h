@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __MEM_BENCH_H__
+#define __MEM_BENCH_H__
+
+#include <stddef.h>
+
+/*
+ * lib/stdlib/mem.c is compiled twice against the firmware headers, with its
+ * functions renamed so that they don't clash with the host C library: once
+ * with the word-at-a-time implementations (fw_ prefix) and once with
+ * USE_SMALL_MEM_FUNCS=1 (fw_small_ prefix).
+ */
+void *fw_memset(void *dst, int val, size_t count);
+int fw_memcmp(const void *s1, const void *s2, size_t len);
+void *fw_memcpy(void *dst, const void *src, size_t len);
+void *fw_memmove(void *dst, const void *src, size_t len);
+void *fw_memchr(const void *src, int c, size_t len);
+
+void *fw_small_memset(void *dst, int val, size_t count);
+int fw_small_memcmp(const void *s1, const void *s2, size_t len);
+void *fw_small_memcpy(void *dst, const void *src, size_t len);
+void *fw_small_memmove(void *dst, const void *src, size_t len);
+void *fw_small_memchr(const void *src, int c, size_t len);
+
+#endif /* __MEM_BENCH_H__ */
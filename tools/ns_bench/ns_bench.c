@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include "ns_bench.h"
+
+/*
+ * ns_bench is a bare metal Normal world payload, loaded as BL33, that measures
+ * the runtime services of BL31 from the Normal world. It finds the CPUs of the
+ * system with PSCI, runs its tests on one CPU and then on all the CPUs
+ * concurrently, prints the results on the UART and turns the system off.
+ */
+
+/* PL011 registers and bits, from include/drivers/arm/pl011.h */
+#define UARTDR			0x000
+#define UARTFR			0x018
+#define UARTIBRD		0x024
+#define UARTFBRD		0x028
+#define UARTLCR_H		0x02C
+#define UARTCR			0x030
+
+#define PL011_UARTFR_TXFF	(1 << 5)
+#define PL011_UARTLCR_H_WLEN_8	(3 << 5)
+#define PL011_UARTLCR_H_FEN	(1 << 4)
+#define PL011_UARTCR_RXE	(1 << 9)
+#define PL011_UARTCR_TXE	(1 << 8)
+#define PL011_UARTCR_UARTEN	(1 << 0)
+
+#define NS_BENCH_UART_BAUDRATE	115200
+
+#define uart_reg(_off)		\
+	(*(volatile uint32_t *)((uintptr_t)NS_BENCH_UART_BASE + (_off)))
+
+void ns_bench_entrypoint(void);
+void ns_bench_secondary_entrypoint(void);
+void ns_bench_main(unsigned int cpu);
+void ns_bench_secondary_main(unsigned int cpu);
+void ns_bench_exception(unsigned int vector);
+
+static uint64_t cpu_mpidr[NS_BENCH_MAX_CPUS];
+static int cpu_present[NS_BENCH_MAX_CPUS];
+static uint64_t counter_freq;
+
+/* Function run by each CPU turned on by ns_bench_cpu_on() */
+static ns_bench_cpu_fn_t volatile cpu_on_fn[NS_BENCH_MAX_CPUS];
+
+/* State shared with the other CPUs by ns_bench_run_on_all_cpus() */
+static ns_bench_cpu_fn_t volatile cpu_fn;
+static volatile unsigned int cpus_go;
+static volatile unsigned int cpu_started[NS_BENCH_MAX_CPUS];
+static volatile unsigned int cpu_done[NS_BENCH_MAX_CPUS];
+
+/*******************************************************************************
+ * Console
+ ******************************************************************************/
+void ns_bench_console_init(void)
+{
+#if NS_BENCH_UART_CLK_IN_HZ
+	unsigned int divisor = (NS_BENCH_UART_CLK_IN_HZ * 4) /
+			       NS_BENCH_UART_BAUDRATE;
+
+	uart_reg(UARTCR) = 0;
+	uart_reg(UARTIBRD) = divisor >> 6;
+	uart_reg(UARTFBRD) = divisor & 0x3f;
+	uart_reg(UARTLCR_H) = PL011_UARTLCR_H_WLEN_8 | PL011_UARTLCR_H_FEN;
+	uart_reg(UARTCR) = PL011_UARTCR_RXE | PL011_UARTCR_TXE |
+			   PL011_UARTCR_UARTEN;
+#endif
+}
+
+static void ns_bench_putc(char c)
+{
+	if (c == '\n')
+		ns_bench_putc('\r');
+
+	while ((uart_reg(UARTFR) & PL011_UARTFR_TXFF) != 0)
+		;
+	uart_reg(UARTDR) = (uint32_t)c;
+}
+
+void ns_bench_puts(const char *str)
+{
+	while (*str != '\0')
+		ns_bench_putc(*str++);
+}
+
+/* Print a decimal number, right-aligned in a field of the given width */
+void ns_bench_put_dec(uint64_t val, unsigned int width)
+{
+	char buf[21];
+	unsigned int i = 0;
+
+	do {
+		buf[i++] = (char)('0' + (val % 10));
+		val /= 10;
+	} while (val != 0);
+
+	while (width-- > i)
+		ns_bench_putc(' ');
+	while (i > 0)
+		ns_bench_putc(buf[--i]);
+}
+
+void ns_bench_put_hex(uint64_t val)
+{
+	unsigned int shift = 60;
+
+	ns_bench_puts("0x");
+	while ((shift > 0) && ((val >> shift) == 0))
+		shift -= 4;
+	for (;;) {
+		ns_bench_putc("0123456789abcdef"[(val >> shift) & 0xf]);
+		if (shift == 0)
+			break;
+		shift -= 4;
+	}
+}
+
+/*******************************************************************************
+ * Statistics
+ ******************************************************************************/
+uint64_t ns_bench_ticks_to_ns(uint64_t ticks)
+{
+	return (ticks * 1000000000ULL) / counter_freq;
+}
+
+static void sift_down(uint32_t *s, unsigned int root, unsigned int n)
+{
+	for (;;) {
+		unsigned int child = (2 * root) + 1;
+		uint32_t tmp;
+
+		if (child >= n)
+			return;
+		if ((child + 1 < n) && (s[child + 1] > s[child]))
+			child++;
+		if (s[root] >= s[child])
+			return;
+		tmp = s[root];
+		s[root] = s[child];
+		s[child] = tmp;
+		root = child;
+	}
+}
+
+/* Heap sort, which needs no memory and has a bounded running time */
+static void sort_samples(uint32_t *s, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = n / 2; i > 0; i--)
+		sift_down(s, i - 1, n);
+	for (i = n; i > 1; i--) {
+		uint32_t tmp = s[0];
+
+		s[0] = s[i - 1];
+		s[i - 1] = tmp;
+		sift_down(s, 0, i - 1);
+	}
+}
+
+void ns_bench_print_dist(const char *label, uint32_t *samples,
+			 unsigned int num_samples)
+{
+	ns_bench_puts("    ");
+	ns_bench_puts(label);
+
+	if (num_samples == 0) {
+		ns_bench_puts(" no samples\n");
+		return;
+	}
+
+	sort_samples(samples, num_samples);
+
+	ns_bench_puts(" min");
+	ns_bench_put_dec(ns_bench_ticks_to_ns(samples[0]), 8);
+	ns_bench_puts(" median");
+	ns_bench_put_dec(ns_bench_ticks_to_ns(samples[num_samples / 2]), 8);
+	ns_bench_puts(" p99");
+	ns_bench_put_dec(
+		ns_bench_ticks_to_ns(samples[(num_samples * 99ULL) / 100]), 8);
+	ns_bench_puts(" max");
+	ns_bench_put_dec(ns_bench_ticks_to_ns(samples[num_samples - 1]), 8);
+	ns_bench_puts(" ns\n");
+}
+
+/*******************************************************************************
+ * CPU management
+ ******************************************************************************/
+unsigned int ns_bench_cpu_index(uint64_t mpidr)
+{
+	return (unsigned int)(((mpidr >> 8) & 0xff) * NS_BENCH_CPUS_PER_CLUSTER +
+			      (mpidr & 0xff));
+}
+
+uint64_t ns_bench_cpu_mpidr(unsigned int cpu)
+{
+	return cpu_mpidr[cpu];
+}
+
+int ns_bench_cpu_present(unsigned int cpu)
+{
+	return cpu_present[cpu];
+}
+
+/* Find the CPUs of the probed topology that PSCI knows about */
+static unsigned int probe_cpus(unsigned int self)
+{
+	unsigned int cluster, cpu, num_cpus = 0;
+
+	for (cluster = 0; cluster < NS_BENCH_CLUSTERS; cluster++) {
+		for (cpu = 0; cpu < NS_BENCH_CPUS_PER_CLUSTER; cpu++) {
+			uint64_t mpidr = (cluster << 8) | cpu;
+			unsigned int idx = ns_bench_cpu_index(mpidr);
+			ns_bench_smc_ret_t ret;
+
+			ret = ns_bench_smc(PSCI_AFFINITY_INFO_AARCH64, mpidr,
+					   0, 0);
+			cpu_mpidr[idx] = mpidr;
+			cpu_present[idx] = (idx == self) ||
+				((int)ret.x0 != PSCI_E_INVALID_PARAMS);
+			if (cpu_present[idx] != 0)
+				num_cpus++;
+		}
+	}
+
+	return num_cpus;
+}
+
+int ns_bench_cpu_on(unsigned int cpu, ns_bench_cpu_fn_t fn)
+{
+	ns_bench_smc_ret_t ret;
+
+	cpu_on_fn[cpu] = fn;
+	ns_bench_dsb();
+
+	ret = ns_bench_smc(PSCI_CPU_ON_AARCH64, cpu_mpidr[cpu],
+			   (uintptr_t)ns_bench_secondary_entrypoint, 0);
+	return (int)ret.x0;
+}
+
+static void run_on_all_cpus_secondary(unsigned int cpu)
+{
+	cpu_started[cpu] = 1;
+	ns_bench_sev();
+
+	while (cpus_go == 0)
+		ns_bench_wfe();
+
+	cpu_fn(cpu);
+
+	cpu_done[cpu] = 1;
+	ns_bench_sev();
+}
+
+void ns_bench_run_on_all_cpus(ns_bench_cpu_fn_t fn)
+{
+	unsigned int self = ns_bench_cpu_index(ns_bench_read_mpidr());
+	unsigned int cpu;
+	ns_bench_smc_ret_t ret;
+
+	cpu_fn = fn;
+	cpus_go = 0;
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		cpu_started[cpu] = 0;
+		cpu_done[cpu] = 0;
+	}
+	ns_bench_dsb();
+
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		if ((cpu == self) || (cpu_present[cpu] == 0))
+			continue;
+
+		if (ns_bench_cpu_on(cpu, run_on_all_cpus_secondary) !=
+		    PSCI_E_SUCCESS) {
+			ns_bench_puts("ns_bench: CPU_ON ");
+			ns_bench_put_hex(cpu_mpidr[cpu]);
+			ns_bench_puts(" failed\n");
+			cpu_started[cpu] = 1;
+			cpu_done[cpu] = 1;
+			continue;
+		}
+
+		while (cpu_started[cpu] == 0)
+			ns_bench_wfe();
+	}
+
+	/* Release all the CPUs together */
+	cpus_go = 1;
+	ns_bench_sev();
+
+	fn(self);
+
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		if ((cpu == self) || (cpu_present[cpu] == 0))
+			continue;
+
+		while (cpu_done[cpu] == 0)
+			ns_bench_wfe();
+
+		/* Wait for the CPU to be off, so that it can be turned on again */
+		do {
+			ret = ns_bench_smc(PSCI_AFFINITY_INFO_AARCH64,
+					   cpu_mpidr[cpu], 0, 0);
+		} while ((int)ret.x0 != PSCI_AFF_STATE_OFF);
+	}
+}
+
+void ns_bench_secondary_main(unsigned int cpu)
+{
+	cpu_on_fn[cpu](cpu);
+
+	(void)ns_bench_smc(PSCI_CPU_OFF, 0, 0, 0);
+}
+
+void ns_bench_exception(unsigned int vector)
+{
+	ns_bench_puts("ns_bench: unexpected exception ");
+	ns_bench_put_dec(vector, 0);
+	ns_bench_puts(" on CPU ");
+	ns_bench_put_hex(ns_bench_read_mpidr());
+	ns_bench_putc('\n');
+}
+
+void ns_bench_main(unsigned int cpu)
+{
+	unsigned int num_cpus;
+
+	ns_bench_console_init();
+
+	__asm__ volatile("mrs	%0, cntfrq_el0" : "=r" (counter_freq));
+
+	num_cpus = probe_cpus(cpu);
+
+	ns_bench_puts("ns_bench: ");
+	ns_bench_put_dec(num_cpus, 0);
+	ns_bench_puts(" CPUs, counter frequency ");
+	ns_bench_put_dec(counter_freq, 0);
+	ns_bench_puts(" Hz\n");
+
+	smc_bench_run();
+	psci_stress_run();
+
+	ns_bench_puts("ns_bench: done\n");
+	(void)ns_bench_smc(PSCI_SYSTEM_OFF, 0, 0, 0);
+}
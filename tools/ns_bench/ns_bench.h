@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __NS_BENCH_H__
+#define __NS_BENCH_H__
+
+/*
+ * Topology probed by the payload. CPUs are identified by MPIDR_EL1, with the
+ * cluster in Aff1 and the CPU in Aff0. The platform Makefile fragment may
+ * override these limits.
+ */
+#ifndef NS_BENCH_CLUSTERS
+#define NS_BENCH_CLUSTERS		2
+#endif
+#ifndef NS_BENCH_CPUS_PER_CLUSTER
+#define NS_BENCH_CPUS_PER_CLUSTER	4
+#endif
+#define NS_BENCH_MAX_CPUS		(NS_BENCH_CLUSTERS *		\
+					 NS_BENCH_CPUS_PER_CLUSTER)
+
+#define NS_BENCH_STACK_SIZE		0x1000
+
+/* Size of the context saved by ns_bench_cpu_suspend(): x19-x30 and sp */
+#define NS_BENCH_SUSPEND_CTX_SIZE	0x68
+
+/*
+ * PSCI function IDs and return codes, from include/lib/psci/psci.h, which
+ * can't be included outside of the firmware.
+ */
+#define PSCI_CPU_SUSPEND_AARCH64	0xc4000001
+#define PSCI_CPU_OFF			0x84000002
+#define PSCI_CPU_ON_AARCH64		0xc4000003
+#define PSCI_AFFINITY_INFO_AARCH64	0xc4000004
+#define PSCI_SYSTEM_OFF			0x84000008
+#define PSCI_FEATURES			0x8400000a
+
+#define PSCI_E_SUCCESS			0
+#define PSCI_E_NOT_SUPPORTED		-1
+#define PSCI_E_INVALID_PARAMS		-2
+
+#define PSCI_AFF_STATE_OFF		1
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/* Values returned in x0 and x1 by an SMC */
+typedef struct ns_bench_smc_ret {
+	uint64_t x0;
+	uint64_t x1;
+} ns_bench_smc_ret_t;
+
+/*
+ * Issue an SMC. The SMC Calling Convention allows the callee to corrupt
+ * x4-x17.
+ */
+static inline ns_bench_smc_ret_t ns_bench_smc(uint64_t fid, uint64_t arg1,
+					      uint64_t arg2, uint64_t arg3)
+{
+	register uint64_t x0 __asm__("x0") = fid;
+	register uint64_t x1 __asm__("x1") = arg1;
+	register uint64_t x2 __asm__("x2") = arg2;
+	register uint64_t x3 __asm__("x3") = arg3;
+	ns_bench_smc_ret_t ret;
+
+	__asm__ volatile("smc	#0"
+			 : "+r" (x0), "+r" (x1), "+r" (x2), "+r" (x3)
+			 :
+			 : "x4", "x5", "x6", "x7", "x8", "x9", "x10", "x11",
+			   "x12", "x13", "x14", "x15", "x16", "x17", "memory");
+
+	ret.x0 = x0;
+	ret.x1 = x1;
+	return ret;
+}
+
+/* Read the physical counter, after all the previous instructions */
+static inline uint64_t ns_bench_read_counter(void)
+{
+	uint64_t val;
+
+	__asm__ volatile("isb\n\tmrs	%0, cntpct_el0" : "=r" (val) : :
+			 "memory");
+	return val;
+}
+
+static inline uint64_t ns_bench_read_mpidr(void)
+{
+	uint64_t val;
+
+	__asm__ volatile("mrs	%0, mpidr_el1" : "=r" (val));
+	return val;
+}
+
+/*
+ * Caches are off in the payload, so all the data accesses are to
+ * Device memory and are seen by the other CPUs in order once they complete.
+ */
+static inline void ns_bench_dsb(void)
+{
+	__asm__ volatile("dsb	sy" : : : "memory");
+}
+
+static inline void ns_bench_sev(void)
+{
+	__asm__ volatile("dsb	sy\n\tsev" : : : "memory");
+}
+
+static inline void ns_bench_wfe(void)
+{
+	__asm__ volatile("wfe" : : : "memory");
+}
+
+/* Console output, on the UART selected at build time */
+void ns_bench_console_init(void);
+void ns_bench_puts(const char *str);
+void ns_bench_put_dec(uint64_t val, unsigned int width);
+void ns_bench_put_hex(uint64_t val);
+
+/* Conversion of counter ticks to nanoseconds */
+uint64_t ns_bench_ticks_to_ns(uint64_t ticks);
+
+/* Sort samples and print their minimum, median, 99th percentile and maximum */
+void ns_bench_print_dist(const char *label, uint32_t *samples,
+			 unsigned int num_samples);
+
+/*
+ * Run a function concurrently on all the CPUs that the payload has found. The
+ * function is called with the linear index of the CPU. The other CPUs are
+ * turned on with PSCI CPU_ON and turned off again when they return.
+ */
+typedef void (*ns_bench_cpu_fn_t)(unsigned int cpu);
+void ns_bench_run_on_all_cpus(ns_bench_cpu_fn_t fn);
+
+/*
+ * Turn on a CPU with PSCI CPU_ON to run a function, after which the CPU turns
+ * itself off. Returns the PSCI return code of CPU_ON.
+ */
+int ns_bench_cpu_on(unsigned int cpu, ns_bench_cpu_fn_t fn);
+
+/*
+ * Issue PSCI CPU_SUSPEND. If the CPU is powered down, it resumes from the
+ * context saved in 'ctx', which must be NS_BENCH_SUSPEND_CTX_SIZE bytes large,
+ * and returns PSCI_E_SUCCESS. Otherwise, returns the PSCI return code.
+ */
+int ns_bench_cpu_suspend(uint32_t power_state, uint64_t *ctx);
+
+/* Linear index and MPIDR of the CPUs that the payload has found */
+unsigned int ns_bench_cpu_index(uint64_t mpidr);
+uint64_t ns_bench_cpu_mpidr(unsigned int cpu);
+int ns_bench_cpu_present(unsigned int cpu);
+
+/* Tests */
+void smc_bench_run(void);
+void psci_stress_run(void);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __NS_BENCH_H__ */
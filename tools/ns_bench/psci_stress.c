@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include "ns_bench.h"
+
+/*
+ * Stress the PSCI power state coordination with CPU_SUSPEND requests issued
+ * by all the CPUs concurrently, while CPUs of the same clusters are turned on
+ * and off. In each cluster, the CPU with Aff0 == 0 repeatedly turns on the CPU
+ * with Aff0 == 1, which suspends a few times and turns itself off again. Each
+ * CPU suspends in turn in the power states of the table below that the
+ * firmware accepts, and is woken up by its EL1 physical timer after a
+ * pseudo-random delay. A CPU stuck in the firmware shows up as the lack of a
+ * final report.
+ */
+
+#ifndef PSCI_STRESS_ITERATIONS
+#define PSCI_STRESS_ITERATIONS		1000
+#endif
+
+/* Number of suspends of a CPU turned on by the CPU with Aff0 == 0 */
+#define PSCI_STRESS_SUSPENDS_PER_ON	8
+
+/* Bounds of the delay before a suspended CPU is woken up */
+#define PSCI_STRESS_MIN_WAKE_US		10
+#define PSCI_STRESS_MAX_WAKE_US		200
+
+/* Non-secure EL1 physical timer interrupt, a PPI */
+#define TIMER_INTID			30
+#define TIMER_PRIORITY			0x80
+
+/* GICv3 Redistributor registers, from include/drivers/arm/gicv3.h */
+#define GICR_TYPER			0x08
+#define GICR_SGI_BASE			0x10000
+#define GICR_ISENABLER0			0x100
+#define GICR_IPRIORITYR			0x400
+
+#define GICR_TYPER_VLPIS		(1 << 1)
+#define GICR_TYPER_LAST			(1 << 4)
+#define GICR_FRAME_SIZE			0x20000
+#define GICR_VLPI_FRAME_SIZE		0x40000
+
+/* GICv3 CPU interface system registers, from include/lib/aarch64/arch.h */
+#define ICC_SRE_EL1			"S3_0_C12_C12_5"
+#define ICC_SRE_EL2			"S3_4_C12_C9_5"
+#define ICC_PMR_EL1			"S3_0_C4_C6_0"
+#define ICC_IGRPEN1_EL1			"S3_0_C12_C12_7"
+
+#define ICC_SRE_SRE_BIT			(1 << 0)
+#define ICC_SRE_EN_BIT			(1 << 3)
+
+/* GICv2 registers, from include/drivers/arm/gic_common.h and gicv2.h */
+#define GICD_ISENABLER			0x100
+#define GICD_IPRIORITYR			0x400
+#define GICC_CTLR			0x000
+#define GICC_PMR			0x004
+
+#define GICC_CTLR_ENABLE		(1 << 0)
+
+#define GIC_PRI_MASK			0xff
+
+#define mmio8(_addr)			(*(volatile uint8_t *)(_addr))
+#define mmio32(_addr)			(*(volatile uint32_t *)(_addr))
+#define mmio64(_addr)			(*(volatile uint64_t *)(_addr))
+
+#define CNTP_CTL_ENABLE			(1 << 0)
+
+#define PSTATE_TYPE_POWERDOWN		1
+#define PSCI_FEATURES_EXT_STATE_ID	(1 << 1)
+
+/*
+ * Power states requested by the test, with the state IDs of the recommended
+ * encoding of the ARM platforms (ARM_RECOM_STATE_ID_ENC=1): one hex digit for
+ * the local state of each power level, 1 for retention and 2 for off.
+ */
+typedef struct psci_stress_state {
+	const char *name;
+	uint32_t state_id;
+	uint32_t pwr_lvl;
+	uint32_t type;
+
+	/* Power state parameter accepted by the firmware, if any */
+	uint32_t power_state;
+	int supported;
+} psci_stress_state_t;
+
+static psci_stress_state_t psci_stress_states[] = {
+	{ "CPU retention    ", 0x01, 0, 0 },
+	{ "CPU off          ", 0x02, 0, PSTATE_TYPE_POWERDOWN },
+	{ "cluster retention", 0x11, 1, 0 },
+	{ "cluster off      ", 0x22, 1, PSTATE_TYPE_POWERDOWN },
+};
+
+#define PSCI_STRESS_NUM_STATES		\
+	(sizeof(psci_stress_states) / sizeof(psci_stress_states[0]))
+
+static int psci_ext_state_id;
+static unsigned int psci_stress_self;
+static uint64_t wake_ticks_per_us;
+
+#if NS_BENCH_GIC_VERSION == 3
+static uintptr_t gicr_base[NS_BENCH_MAX_CPUS];
+#endif
+static uint64_t suspend_ctx[NS_BENCH_MAX_CPUS][NS_BENCH_SUSPEND_CTX_SIZE / 8];
+static uint32_t rand_state[NS_BENCH_MAX_CPUS];
+
+static unsigned int num_suspends[NS_BENCH_MAX_CPUS][PSCI_STRESS_NUM_STATES];
+static unsigned int num_failed[NS_BENCH_MAX_CPUS][PSCI_STRESS_NUM_STATES];
+static unsigned int num_cpu_on[NS_BENCH_MAX_CPUS];
+static unsigned int num_cpu_on_failed[NS_BENCH_MAX_CPUS];
+
+static uint32_t psci_stress_rand(unsigned int cpu)
+{
+	rand_state[cpu] = (rand_state[cpu] * 1103515245U) + 12345U;
+	return rand_state[cpu] >> 16;
+}
+
+/*******************************************************************************
+ * Wake-up interrupt
+ ******************************************************************************/
+#if NS_BENCH_GIC_VERSION == 3
+static int current_el_is_el2(void)
+{
+	uint64_t el;
+
+	__asm__ volatile("mrs	%0, CurrentEL" : "=r" (el));
+	return ((el >> 2) & 0x3) == 2;
+}
+
+static uintptr_t gicr_find(uint64_t mpidr)
+{
+	uintptr_t base = NS_BENCH_GICR_BASE;
+
+	for (;;) {
+		uint64_t typer = mmio64(base + GICR_TYPER);
+
+		if (((typer >> 32) & 0xffffff) == (mpidr & 0xffffff))
+			return base;
+		if ((typer & GICR_TYPER_LAST) != 0)
+			return 0;
+		base += ((typer & GICR_TYPER_VLPIS) != 0) ?
+			GICR_VLPI_FRAME_SIZE : GICR_FRAME_SIZE;
+	}
+}
+#endif
+
+/*
+ * Enable the timer interrupt in the GIC for this CPU. The firmware resets the
+ * Non-secure state of the CPU interface and of the PPIs when the CPU is
+ * powered up, so this is done after each suspend.
+ */
+static void psci_stress_gic_init(unsigned int cpu)
+{
+#if NS_BENCH_GIC_VERSION == 3
+	uintptr_t sgi_base = gicr_base[cpu] + GICR_SGI_BASE;
+	uint64_t sre;
+
+	mmio8(sgi_base + GICR_IPRIORITYR + TIMER_INTID) = TIMER_PRIORITY;
+	mmio32(sgi_base + GICR_ISENABLER0) = 1U << TIMER_INTID;
+
+	if (current_el_is_el2() != 0) {
+		__asm__ volatile("mrs	%0, " ICC_SRE_EL2 : "=r" (sre));
+		sre |= ICC_SRE_SRE_BIT | ICC_SRE_EN_BIT;
+		__asm__ volatile("msr	" ICC_SRE_EL2 ", %0\n\tisb" : :
+				 "r" (sre));
+	}
+	__asm__ volatile("mrs	%0, " ICC_SRE_EL1 : "=r" (sre));
+	sre |= ICC_SRE_SRE_BIT;
+	__asm__ volatile("msr	" ICC_SRE_EL1 ", %0\n\tisb" : : "r" (sre));
+
+	__asm__ volatile("msr	" ICC_PMR_EL1 ", %0" : :
+			 "r" ((uint64_t)GIC_PRI_MASK));
+	__asm__ volatile("msr	" ICC_IGRPEN1_EL1 ", %0\n\tisb" : :
+			 "r" ((uint64_t)1));
+#else
+	(void)cpu;
+
+	mmio8(NS_BENCH_GICD_BASE + GICD_IPRIORITYR + TIMER_INTID) =
+		TIMER_PRIORITY;
+	mmio32(NS_BENCH_GICD_BASE + GICD_ISENABLER) = 1U << TIMER_INTID;
+
+	mmio32(NS_BENCH_GICC_BASE + GICC_PMR) = GIC_PRI_MASK;
+	mmio32(NS_BENCH_GICC_BASE + GICC_CTLR) = GICC_CTLR_ENABLE;
+#endif
+}
+
+/*
+ * The timer interrupt is level-sensitive, so disabling the timer also
+ * removes the pending interrupt. It is never acknowledged, as interrupts are
+ * masked in the payload and only wake the CPU up.
+ */
+static void psci_stress_timer_set(uint64_t ticks)
+{
+	__asm__ volatile("msr	cntp_tval_el0, %0\n\t"
+			 "msr	cntp_ctl_el0, %1\n\t"
+			 "isb"
+			 : : "r" (ticks), "r" ((uint64_t)CNTP_CTL_ENABLE));
+}
+
+static void psci_stress_timer_cancel(void)
+{
+	__asm__ volatile("msr	cntp_ctl_el0, xzr\n\tisb");
+}
+
+/*******************************************************************************
+ * Test
+ ******************************************************************************/
+static uint32_t make_power_state(const psci_stress_state_t *state,
+				 uint32_t state_id)
+{
+	if (psci_ext_state_id != 0)
+		return state_id | (state->type << 30);
+
+	return state_id | (state->type << 16) | (state->pwr_lvl << 24);
+}
+
+static int psci_stress_suspend(unsigned int cpu, uint32_t power_state)
+{
+	uint32_t wake_us = PSCI_STRESS_MIN_WAKE_US + (psci_stress_rand(cpu) %
+		(PSCI_STRESS_MAX_WAKE_US - PSCI_STRESS_MIN_WAKE_US));
+	int rc;
+
+	psci_stress_timer_set(wake_us * wake_ticks_per_us);
+	rc = ns_bench_cpu_suspend(power_state, suspend_ctx[cpu]);
+	psci_stress_timer_cancel();
+	psci_stress_gic_init(cpu);
+
+	return rc;
+}
+
+static void psci_stress_suspend_any(unsigned int cpu)
+{
+	unsigned int i = psci_stress_rand(cpu) % PSCI_STRESS_NUM_STATES;
+
+	while (psci_stress_states[i].supported == 0)
+		i = (i + 1) % PSCI_STRESS_NUM_STATES;
+
+	if (psci_stress_suspend(cpu, psci_stress_states[i].power_state) ==
+	    PSCI_E_SUCCESS)
+		num_suspends[cpu][i]++;
+	else
+		num_failed[cpu][i]++;
+}
+
+static int psci_stress_is_off(unsigned int cpu)
+{
+	ns_bench_smc_ret_t ret;
+
+	ret = ns_bench_smc(PSCI_AFFINITY_INFO_AARCH64, ns_bench_cpu_mpidr(cpu),
+			   0, 0);
+	return (int)ret.x0 == PSCI_AFF_STATE_OFF;
+}
+
+/*
+ * Whether the CPU turns on the CPU with Aff0 == 1 of its cluster, which must
+ * be present and not be the one running the tests.
+ */
+static int psci_stress_is_hotplug_driver(unsigned int cpu)
+{
+	if ((NS_BENCH_CPUS_PER_CLUSTER < 2) ||
+	    ((ns_bench_cpu_mpidr(cpu) & 0xff) != 0))
+		return 0;
+
+	return (ns_bench_cpu_present(cpu) != 0) &&
+		(ns_bench_cpu_present(cpu + 1) != 0) &&
+		(cpu + 1 != psci_stress_self);
+}
+
+/* Function of a CPU turned on by the CPU with Aff0 == 0 of its cluster */
+static void psci_stress_hotplugged_cpu(unsigned int cpu)
+{
+	unsigned int i;
+
+	psci_stress_gic_init(cpu);
+
+	for (i = 0; i < PSCI_STRESS_SUSPENDS_PER_ON; i++)
+		psci_stress_suspend_any(cpu);
+}
+
+static void psci_stress_cpu(unsigned int cpu)
+{
+	unsigned int i, partner = cpu + 1;
+	int rc;
+
+	/* A hotplugged CPU returns and turns off until it is turned on again */
+	if ((cpu != psci_stress_self) && (cpu > 0) &&
+	    psci_stress_is_hotplug_driver(cpu - 1))
+		return;
+
+	psci_stress_gic_init(cpu);
+
+	for (i = 0; i < PSCI_STRESS_ITERATIONS; i++) {
+		if (psci_stress_is_hotplug_driver(cpu) &&
+		    psci_stress_is_off(partner)) {
+			rc = ns_bench_cpu_on(partner,
+					     psci_stress_hotplugged_cpu);
+			if (rc == PSCI_E_SUCCESS)
+				num_cpu_on[cpu]++;
+			else
+				num_cpu_on_failed[cpu]++;
+		}
+
+		psci_stress_suspend_any(cpu);
+	}
+
+	if (psci_stress_is_hotplug_driver(cpu)) {
+		while (psci_stress_is_off(partner) == 0)
+			;
+	}
+}
+
+/*
+ * Find the power states that the firmware accepts, on this CPU alone. The
+ * default encoding of the ARM platforms expects a zero state ID.
+ */
+static unsigned int psci_stress_probe_states(unsigned int self)
+{
+	unsigned int i, num_states = 0;
+
+	for (i = 0; i < PSCI_STRESS_NUM_STATES; i++) {
+		psci_stress_state_t *state = &psci_stress_states[i];
+		int rc;
+
+		state->power_state = make_power_state(state, state->state_id);
+		rc = psci_stress_suspend(self, state->power_state);
+		if ((rc == PSCI_E_INVALID_PARAMS) && (psci_ext_state_id == 0)) {
+			state->power_state = make_power_state(state, 0);
+			rc = psci_stress_suspend(self, state->power_state);
+		}
+
+		state->supported = (rc == PSCI_E_SUCCESS);
+		if (state->supported != 0)
+			num_states++;
+	}
+
+	return num_states;
+}
+
+static void psci_stress_report(void)
+{
+	unsigned int i, cpu, suspends, failed, cpu_on = 0, cpu_on_failed = 0;
+
+	for (i = 0; i < PSCI_STRESS_NUM_STATES; i++) {
+		ns_bench_puts("  ");
+		ns_bench_puts(psci_stress_states[i].name);
+		if (psci_stress_states[i].supported == 0) {
+			ns_bench_puts(" not supported\n");
+			continue;
+		}
+
+		suspends = 0;
+		failed = 0;
+		for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+			suspends += num_suspends[cpu][i];
+			failed += num_failed[cpu][i];
+		}
+		ns_bench_put_dec(suspends, 8);
+		ns_bench_puts(" suspends, ");
+		ns_bench_put_dec(failed, 0);
+		ns_bench_puts(" failed\n");
+	}
+
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		cpu_on += num_cpu_on[cpu];
+		cpu_on_failed += num_cpu_on_failed[cpu];
+	}
+	ns_bench_puts("  CPU_ON           ");
+	ns_bench_put_dec(cpu_on, 8);
+	ns_bench_puts(" calls,    ");
+	ns_bench_put_dec(cpu_on_failed, 0);
+	ns_bench_puts(" failed\n");
+}
+
+void psci_stress_run(void)
+{
+	unsigned int cpu;
+	uint64_t freq;
+	ns_bench_smc_ret_t ret;
+
+	psci_stress_self = ns_bench_cpu_index(ns_bench_read_mpidr());
+
+	ret = ns_bench_smc(PSCI_FEATURES, PSCI_CPU_SUSPEND_AARCH64, 0, 0);
+	if ((int)ret.x0 < 0) {
+		ns_bench_puts("psci_stress: CPU_SUSPEND is not supported\n");
+		return;
+	}
+	psci_ext_state_id = ((ret.x0 & PSCI_FEATURES_EXT_STATE_ID) != 0);
+
+	__asm__ volatile("mrs	%0, cntfrq_el0" : "=r" (freq));
+	wake_ticks_per_us = (freq + 999999) / 1000000;
+
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		if (ns_bench_cpu_present(cpu) == 0)
+			continue;
+
+		rand_state[cpu] = cpu + 1;
+#if NS_BENCH_GIC_VERSION == 3
+		gicr_base[cpu] = gicr_find(ns_bench_cpu_mpidr(cpu));
+		if (gicr_base[cpu] == 0) {
+			ns_bench_puts("psci_stress: no Redistributor for CPU ");
+			ns_bench_put_hex(ns_bench_cpu_mpidr(cpu));
+			ns_bench_puts("\n");
+			return;
+		}
+#endif
+	}
+
+	psci_stress_gic_init(psci_stress_self);
+	if (psci_stress_probe_states(psci_stress_self) == 0) {
+		ns_bench_puts("psci_stress: no power state is supported\n");
+		return;
+	}
+
+	ns_bench_puts("psci_stress: ");
+	ns_bench_put_dec(PSCI_STRESS_ITERATIONS, 0);
+	ns_bench_puts(" suspends per CPU, all CPUs\n");
+	ns_bench_run_on_all_cpus(psci_stress_cpu);
+	psci_stress_report();
+}
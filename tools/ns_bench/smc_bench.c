@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <smcc.h>
+#include <stdint.h>
+#include <tsp.h>
+
+#include "ns_bench.h"
+
+/*
+ * Measure the round trip of an SMC from the Normal world to the TSP and back,
+ * with the TSP_NOP service. The TSP returns in x1 the value of the physical
+ * counter on entry into its handler, which splits the round trip into the
+ * entry into the TSP and the return to the Normal world.
+ */
+
+#ifndef SMC_BENCH_ITERATIONS
+#define SMC_BENCH_ITERATIONS	10000
+#endif
+
+/* Calls made before recording, to warm up the caches and the TLBs */
+#define SMC_BENCH_WARMUP	100
+
+static uint32_t round_trip[NS_BENCH_MAX_CPUS][SMC_BENCH_ITERATIONS];
+static uint32_t to_secure[NS_BENCH_MAX_CPUS][SMC_BENCH_ITERATIONS];
+static uint32_t to_normal[NS_BENCH_MAX_CPUS][SMC_BENCH_ITERATIONS];
+static unsigned int num_samples[NS_BENCH_MAX_CPUS];
+static unsigned int num_preempted[NS_BENCH_MAX_CPUS];
+
+static uint32_t smc_bench_fid;
+
+static void smc_bench_cpu(unsigned int cpu)
+{
+	unsigned int i, n = 0, preempted = 0;
+
+	for (i = 0; i < SMC_BENCH_WARMUP + SMC_BENCH_ITERATIONS; i++) {
+		ns_bench_smc_ret_t ret;
+		uint64_t start, end;
+
+		start = ns_bench_read_counter();
+		ret = ns_bench_smc(smc_bench_fid, 0, 0, 0);
+		end = ns_bench_read_counter();
+
+		/*
+		 * A yielding call may be preempted by a Normal world
+		 * interrupt. Complete it, but don't record the round trip.
+		 */
+		if ((int)ret.x0 == SMC_PREEMPTED) {
+			while ((int)ret.x0 == SMC_PREEMPTED)
+				ret = ns_bench_smc(TSP_FID_RESUME, 0, 0, 0);
+			preempted++;
+			continue;
+		}
+
+		if (i < SMC_BENCH_WARMUP)
+			continue;
+
+		round_trip[cpu][n] = (uint32_t)(end - start);
+		to_secure[cpu][n] = (uint32_t)(ret.x1 - start);
+		to_normal[cpu][n] = (uint32_t)(end - ret.x1);
+		n++;
+	}
+
+	num_samples[cpu] = n;
+	num_preempted[cpu] = preempted;
+}
+
+static void smc_bench_report(unsigned int cpu)
+{
+	ns_bench_puts("  CPU ");
+	ns_bench_put_hex(ns_bench_cpu_mpidr(cpu));
+	ns_bench_puts(": ");
+	ns_bench_put_dec(num_samples[cpu], 0);
+	ns_bench_puts(" calls");
+	if (num_preempted[cpu] != 0) {
+		ns_bench_puts(", ");
+		ns_bench_put_dec(num_preempted[cpu], 0);
+		ns_bench_puts(" preempted calls ignored");
+	}
+	ns_bench_puts("\n");
+
+	ns_bench_print_dist("round trip ", round_trip[cpu], num_samples[cpu]);
+	ns_bench_print_dist("NS -> S-EL1", to_secure[cpu], num_samples[cpu]);
+	ns_bench_print_dist("S-EL1 -> NS", to_normal[cpu], num_samples[cpu]);
+}
+
+static void smc_bench_one(uint32_t fid, const char *name)
+{
+	unsigned int self = ns_bench_cpu_index(ns_bench_read_mpidr());
+	unsigned int cpu;
+
+	smc_bench_fid = fid;
+
+	ns_bench_puts("smc_bench: ");
+	ns_bench_puts(name);
+	ns_bench_puts(", one CPU\n");
+	smc_bench_cpu(self);
+	smc_bench_report(self);
+
+	ns_bench_puts("smc_bench: ");
+	ns_bench_puts(name);
+	ns_bench_puts(", all CPUs\n");
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		num_samples[cpu] = 0;
+		num_preempted[cpu] = 0;
+	}
+	ns_bench_run_on_all_cpus(smc_bench_cpu);
+	for (cpu = 0; cpu < NS_BENCH_MAX_CPUS; cpu++) {
+		if (ns_bench_cpu_present(cpu) != 0)
+			smc_bench_report(cpu);
+	}
+}
+
+void smc_bench_run(void)
+{
+	ns_bench_smc_ret_t ret;
+
+	ret = ns_bench_smc(TSP_FAST_FID(TSP_NOP), 0, 0, 0);
+	if (ret.x0 != 0) {
+		ns_bench_puts("smc_bench: TSP_NOP is not supported, BL31 must "
+			      "be built with SPD=tspd\n");
+		return;
+	}
+
+	smc_bench_one(TSP_FAST_FID(TSP_NOP), "fast TSP_NOP");
+	smc_bench_one(TSP_YIELD_FID(TSP_NOP), "yielding TSP_NOP");
+}
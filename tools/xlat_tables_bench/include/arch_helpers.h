@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+/*
+ * Replacement of the architectural helpers used by the xlat_tables_v2 library
+ * when it is built for the host by xlat_tables_bench. The translation tables
+ * are only read by the tool itself, so no barrier is needed.
+ */
+
+static inline void dsbish(void)
+{
+}
+
+static inline void dsbishst(void)
+{
+}
+
+static inline void isb(void)
+{
+}
+
+#endif /* __ARCH_HELPERS_H__ */
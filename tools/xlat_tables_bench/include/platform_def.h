@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __PLATFORM_DEF_H__
+#define __PLATFORM_DEF_H__
+
+#include <utils_def.h>
+
+/*
+ * Configuration of the translation table library for xlat_tables_bench. The
+ * address spaces are large enough for the random memory maps of the tool, see
+ * xlat_tables_bench_ctx.c.
+ */
+#define PLAT_VIRT_ADDR_SPACE_SIZE	(ULL(1) << 32)
+#define PLAT_PHY_ADDR_SPACE_SIZE	(ULL(1) << 40)
+#define MAX_MMAP_REGIONS		64
+#define MAX_XLAT_TABLES			256
+#define PLAT_XLAT_TABLES_DYNAMIC	1
+
+#endif /* __PLATFORM_DEF_H__ */
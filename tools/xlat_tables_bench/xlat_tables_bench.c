@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "xlat_tables_bench.h"
+
+/*
+ * This tool runs the xlat_tables_v2 library on the host, so that changes to it
+ * can be checked and measured without booting the firmware. It maps random
+ * static memory maps, then adds and removes random dynamic regions and changes
+ * the attributes of random ranges. The translation tables are compared to a
+ * reference model of the memory map, and the time spent in each operation is
+ * reported.
+ */
+
+/* Log level of the library messages that are output, see debug.h */
+#define LOG_LEVEL_ERROR		10
+#define LOG_LEVEL_INFO		40
+
+static unsigned int max_log_level = LOG_LEVEL_ERROR;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: xlat_tables_bench [-c] [-v] [-s <seed>] [-r <runs>] [-n <ops>]\n\n"
+		"  -c  Compare the translation tables to the reference model after\n"
+		"      each operation, instead of only at the end of each run\n"
+		"  -n  Number of operations on the dynamic regions of each memory\n"
+		"      map (default 10000)\n"
+		"  -r  Number of random static memory maps (default 10)\n"
+		"  -s  Seed of the pseudo-random number generator (default 1)\n"
+		"  -v  Output the warnings and information messages of the\n"
+		"      library, not only the errors\n");
+	exit(1);
+}
+
+unsigned long long bench_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bench_out(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void bench_vlog(unsigned int level, const char *fmt, va_list args)
+{
+	if (level <= max_log_level)
+		vfprintf(stderr, fmt, args);
+}
+
+void bench_fail(void)
+{
+	fflush(stdout);
+	fprintf(stderr, "ERROR: Benchmark aborted\n");
+	exit(2);
+}
+
+static unsigned int parse_uint(const char *arg)
+{
+	char *end;
+	unsigned long val = strtoul(arg, &end, 0);
+
+	if ((*arg == '\0') || (*end != '\0') || (val > 0xffffffffUL))
+		usage();
+
+	return val;
+}
+
+int main(int argc, char *argv[])
+{
+	bench_config_t config = {
+		.seed = 1,
+		.runs = 10,
+		.ops = 10000,
+		.check = 0,
+	};
+	unsigned int mismatches;
+	int c;
+
+	while ((c = getopt(argc, argv, "cn:r:s:vh")) != -1) {
+		switch (c) {
+		case 'c':
+			config.check = 1;
+			break;
+		case 'n':
+			config.ops = parse_uint(optarg);
+			break;
+		case 'r':
+			config.runs = parse_uint(optarg);
+			break;
+		case 's':
+			config.seed = parse_uint(optarg);
+			break;
+		case 'v':
+			max_log_level = LOG_LEVEL_INFO;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind != argc)
+		usage();
+
+	mismatches = bench_run(&config);
+	if (mismatches != 0) {
+		fprintf(stderr, "ERROR: %u mismatches with the reference model\n",
+			mismatches);
+		return 1;
+	}
+
+	return 0;
+}
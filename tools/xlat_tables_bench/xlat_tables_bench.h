@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __XLAT_TABLES_BENCH_H__
+#define __XLAT_TABLES_BENCH_H__
+
+#include <stdarg.h>
+
+/*
+ * The translation table library and the code that drives it are compiled
+ * against the firmware headers, in xlat_tables_bench_ctx.c. The rest of the
+ * tool is compiled against the host headers, in xlat_tables_bench.c. This
+ * interface only uses types that are common to both.
+ */
+
+typedef struct bench_config {
+	/* Seed of the pseudo-random number generator */
+	unsigned int seed;
+	/* Number of random static memory maps */
+	unsigned int runs;
+	/* Number of operations on the dynamic regions of each memory map */
+	unsigned int ops;
+	/*
+	 * If set, the translation tables are compared to the reference model
+	 * after each operation. Otherwise, only at the end of each run.
+	 */
+	int check;
+} bench_config_t;
+
+/*
+ * Maps random memory maps, benchmarks the operations on them and outputs the
+ * results with bench_out(). Returns 0 on success, or the number of mismatches
+ * between the translation tables and the reference model.
+ */
+unsigned int bench_run(const bench_config_t *config);
+
+/* Monotonic time in nanoseconds */
+unsigned long long bench_time_ns(void);
+
+/* Output of the results */
+void bench_out(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/* Output of the log messages of the library, 'level' is a LOG_LEVEL_* value */
+void bench_vlog(unsigned int level, const char *fmt, va_list args);
+
+/* Abort the benchmark */
+void bench_fail(void) __attribute__((noreturn));
+
+#endif /* __XLAT_TABLES_BENCH_H__ */
@@ -0,0 +1,744 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <types.h>
+#include <utils_def.h>
+#include <xlat_tables_defs.h>
+#include <xlat_tables_v2.h>
+
+#include "xlat_tables_bench.h"
+
+/*
+ * The static regions are mapped in the lower half of the VA space and the
+ * dynamic regions in the upper half. The reference model holds, for each page
+ * of the VA space, the region that maps it and its expected attributes.
+ */
+#define STATIC_VA_END		(PLAT_VIRT_ADDR_SPACE_SIZE / 2)
+#define DYNAMIC_VA_BASE		STATIC_VA_END
+#define VA_SPACE_END		PLAT_VIRT_ADDR_SPACE_SIZE
+#define MODEL_PAGES		(PLAT_VIRT_ADDR_SPACE_SIZE / PAGE_SIZE)
+
+#define MAX_STATIC_REGIONS	24
+#define MAX_REGIONS		MAX_MMAP_REGIONS
+
+/* Number of mismatches with the reference model that are described */
+#define MAX_REPORTED_MISMATCHES	10
+
+REGISTER_XLAT_CONTEXT(bench, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
+		PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
+
+/* Initial value of the context, restored before each run */
+static xlat_ctx_t bench_ctx_reset;
+
+typedef struct bench_region {
+	mmap_region_t mm;
+	int mapped;
+	int dynamic;
+} bench_region_t;
+
+/* Regions of the current run, the index in the array identifies the region */
+static bench_region_t regions[MAX_REGIONS + 1];
+
+/* Region of each page, 0 if unmapped, and its expected attributes */
+static uint8_t model_region[MODEL_PAGES];
+static uint8_t model_attr[MODEL_PAGES];
+
+typedef struct bench_stats {
+	const char *name;
+	unsigned long long calls;
+	unsigned long long failed;
+	unsigned long long total_ns;
+	unsigned long long max_ns;
+	unsigned long long tlbi_va;
+	unsigned long long tlbi_all;
+} bench_stats_t;
+
+static bench_stats_t stats_add = { .name = "mmap_add_dynamic_region_ctx" };
+static bench_stats_t stats_remove = { .name = "mmap_remove_dynamic_region_ctx" };
+static bench_stats_t stats_change = { .name = "change_mem_attributes" };
+
+static unsigned long long tlbi_va_count, tlbi_all_count;
+static unsigned long long op_start_ns;
+static unsigned int mismatches;
+static unsigned int rand_state;
+static int mmu_enabled;
+
+/*******************************************************************************
+ * Host implementations of the firmware services used by the library.
+ ******************************************************************************/
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	bench_vlog(LOG_LEVEL_VERBOSE, fmt, args);
+	va_end(args);
+}
+
+void tf_log(const char *fmt, ...)
+{
+	va_list args;
+
+	/* The first character of the format string is the log level */
+	va_start(args, fmt);
+	bench_vlog(fmt[0], fmt + 1, args);
+	va_end(args);
+}
+
+#if PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_VERBOSE
+void __assert(const char *file, unsigned int line, const char *assertion)
+{
+	tf_log(LOG_MARKER_ERROR "ASSERT: %s:%d:%s\n", file, line, assertion);
+	bench_fail();
+}
+#elif PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_INFO
+void __assert(const char *file, unsigned int line)
+{
+	tf_log(LOG_MARKER_ERROR "ASSERT: %s:%d\n", file, line);
+	bench_fail();
+}
+#else
+void __assert(void)
+{
+	bench_fail();
+}
+#endif
+
+void do_panic(void)
+{
+	bench_fail();
+}
+
+/*
+ * Replacement of xlat_tables_arch.c. The TLB maintenance operations are only
+ * counted, as an indication of their cost on the target.
+ */
+unsigned long long xlat_arch_get_max_supported_pa(void)
+{
+	return PLAT_PHY_ADDR_SPACE_SIZE - 1;
+}
+
+int is_mmu_enabled_ctx(const xlat_ctx_t *ctx __unused)
+{
+	return mmu_enabled;
+}
+
+void xlat_arch_tlbi_va(uintptr_t va __unused)
+{
+	tlbi_va_count++;
+}
+
+void xlat_arch_tlbi_va_regime(uintptr_t va __unused,
+			      xlat_regime_t xlat_regime __unused)
+{
+	tlbi_va_count++;
+}
+
+void xlat_arch_tlbi_all_regime(xlat_regime_t xlat_regime __unused)
+{
+	tlbi_all_count++;
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+}
+
+void enable_mmu_arch(unsigned int flags __unused,
+		     uint64_t *base_table __unused,
+		     unsigned long long max_pa __unused,
+		     uintptr_t max_va __unused)
+{
+	bench_fail();
+}
+
+/*******************************************************************************
+ * Random memory maps.
+ ******************************************************************************/
+
+/* Returns a pseudo-random number in [0, n), n must not be 0 */
+static unsigned int rand_below(unsigned int n)
+{
+	/* xorshift32 */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state % n;
+}
+
+/*
+ * Returns random attributes. The regions can be executable and writable at the
+ * same time, the library makes them execute-never.
+ */
+static mmap_attr_t bench_random_attr(void)
+{
+	static const mmap_attr_t types[] = {
+		MT_DEVICE, MT_NON_CACHEABLE, MT_MEMORY
+	};
+	mmap_attr_t attr = types[rand_below(ARRAY_SIZE(types))];
+
+	attr |= (rand_below(2) != 0) ? MT_RW : MT_RO;
+	attr |= (rand_below(2) != 0) ? MT_EXECUTE_NEVER : MT_EXECUTE;
+	attr |= (rand_below(4) == 0) ? MT_NS : MT_SECURE;
+	attr |= (rand_below(8) == 0) ? MT_NO_CONTIG_HINT : MT_CONTIG_HINT;
+
+	return attr;
+}
+
+/*
+ * Returns the attributes that get_mem_attributes() reports for a page mapped
+ * with 'attr' in the EL3 translation regime.
+ */
+static mmap_attr_t bench_expected_attr(mmap_attr_t attr)
+{
+	mmap_attr_t expected = attr & (MT_TYPE_MASK | MT_RW | MT_NS);
+
+	if ((MT_TYPE(attr) == MT_DEVICE) ||
+	    ((attr & (MT_RW | MT_EXECUTE_NEVER)) != 0))
+		expected |= MT_EXECUTE_NEVER;
+
+	return expected;
+}
+
+/*
+ * Fills 'mm' with a random region 'id' that starts at 'va_min' or above. A mix
+ * of small and large regions is generated, with VAs and PAs aligned so that the
+ * library maps them with pages, blocks and contiguous groups of both.
+ */
+static void bench_random_region(mmap_region_t *mm, unsigned int id,
+				uintptr_t va_min)
+{
+	static const struct {
+		size_t unit;
+		unsigned int max_units;
+	} kinds[] = {
+		{ PAGE_SIZE, 64 },
+		{ PAGE_SIZE, 2048 },
+		{ XLAT_BLOCK_SIZE(2), 16 },
+		{ XLAT_CONT_SIZE(2), 4 },
+	};
+	unsigned int kind = rand_below(ARRAY_SIZE(kinds));
+	size_t unit = kinds[kind].unit;
+	size_t pa_align = (rand_below(4) == 0) ? PAGE_SIZE : unit;
+	unsigned long long pa_offset;
+
+	mm->base_va = round_up(va_min, unit);
+	mm->size = (1 + rand_below(kinds[kind].max_units)) * unit;
+
+	/*
+	 * The PA is equal to the VA, or in a part of the PA space above the VA
+	 * space that is specific to the region, as the library rejects regions
+	 * with overlapping PAs.
+	 */
+	if (rand_below(4) == 0) {
+		pa_offset = 0;
+	} else {
+		pa_offset = (unsigned long long)id * 2U * VA_SPACE_END;
+		pa_offset += ((unsigned long long)rand_below(VA_SPACE_END /
+				PAGE_SIZE) * PAGE_SIZE) &
+			     ~((unsigned long long)pa_align - 1);
+	}
+	mm->base_pa = mm->base_va + pa_offset;
+
+	mm->attr = bench_random_attr();
+
+	switch (rand_below(8)) {
+	case 0:
+		mm->granularity = PAGE_SIZE;
+		break;
+	case 1:
+		mm->granularity = XLAT_BLOCK_SIZE(2);
+		break;
+	default:
+		mm->granularity = REGION_DEFAULT_GRANULARITY;
+		break;
+	}
+}
+
+static void bench_model_set(unsigned int id)
+{
+	const mmap_region_t *mm = &regions[id].mm;
+	mmap_attr_t attr = bench_expected_attr(mm->attr);
+
+	for (uintptr_t va = mm->base_va; va < mm->base_va + mm->size;
+	     va += PAGE_SIZE) {
+		model_region[va / PAGE_SIZE] = id;
+		model_attr[va / PAGE_SIZE] = attr;
+	}
+}
+
+static void bench_model_clear(unsigned int id)
+{
+	const mmap_region_t *mm = &regions[id].mm;
+
+	for (uintptr_t va = mm->base_va; va < mm->base_va + mm->size;
+	     va += PAGE_SIZE)
+		model_region[va / PAGE_SIZE] = 0;
+}
+
+/*******************************************************************************
+ * Comparison of the translation tables to the reference model.
+ ******************************************************************************/
+
+static void bench_mismatch(uintptr_t va, const char *what)
+{
+	if (mismatches < MAX_REPORTED_MISMATCHES)
+		bench_out("MISMATCH: VA 0x%lx: %s\n", (unsigned long)va, what);
+	else if (mismatches == MAX_REPORTED_MISMATCHES)
+		bench_out("MISMATCH: ...\n");
+
+	mismatches++;
+}
+
+/*
+ * Walks the translation tables to find the block or page descriptor that maps
+ * 'va'. Returns the table that contains it, and its index and lookup level in
+ * '*idx' and '*level', or NULL if 'va' isn't mapped.
+ */
+static const uint64_t *bench_find_desc(uintptr_t va, unsigned int *idx,
+				       unsigned int *level)
+{
+	const uint64_t *table = bench_xlat_ctx.base_table;
+	unsigned int entries = bench_xlat_ctx.base_table_entries;
+	uint64_t desc;
+
+	for (*level = bench_xlat_ctx.base_level; ; (*level)++) {
+		*idx = (va >> XLAT_ADDR_SHIFT(*level)) & (entries - 1);
+		desc = table[*idx];
+
+		if ((desc & DESC_MASK) == INVALID_DESC)
+			return NULL;
+
+		if ((*level == XLAT_TABLE_LEVEL_MAX) ||
+		    ((desc & DESC_MASK) == BLOCK_DESC))
+			return table;
+
+		table = (const uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK);
+		entries = XLAT_TABLE_ENTRIES;
+	}
+}
+
+/*
+ * Checks that all the entries of the contiguous group that contains the entry
+ * 'idx' of 'table' have the contiguous hint, the same attributes and
+ * consecutive output addresses, aligned to the size of the group.
+ */
+static void bench_check_contig(uintptr_t va, const uint64_t *table,
+			       unsigned int idx, unsigned int level)
+{
+	const uint64_t *group = &table[idx & ~(XLAT_CONT_ENTRIES - 1)];
+	unsigned long long pa = group[0] & TABLE_ADDR_MASK;
+
+	if ((pa & XLAT_CONT_MASK(level)) != 0) {
+		bench_mismatch(va, "contiguous group not aligned");
+		return;
+	}
+
+	for (unsigned int i = 0; i < XLAT_CONT_ENTRIES; i++) {
+		if (((group[i] & ~TABLE_ADDR_MASK) !=
+		     (group[0] & ~TABLE_ADDR_MASK)) ||
+		    ((group[i] & TABLE_ADDR_MASK) !=
+		     pa + i * XLAT_BLOCK_SIZE(level))) {
+			bench_mismatch(va, "inconsistent contiguous group");
+			return;
+		}
+	}
+}
+
+/* Compares the pages of the range [base_va, end_va] to the reference model */
+static void bench_check_range(uintptr_t base_va, uintptr_t end_va)
+{
+	const uint64_t *table;
+	const mmap_region_t *mm;
+	unsigned int idx, level, id;
+	unsigned long long pa;
+	mmap_attr_t attr;
+	uint64_t desc;
+
+	for (uintptr_t va = base_va; va <= end_va; va += PAGE_SIZE) {
+		id = model_region[va / PAGE_SIZE];
+		table = bench_find_desc(va, &idx, &level);
+
+		if (id == 0) {
+			if (table != NULL)
+				bench_mismatch(va, "mapped, expected unmapped");
+			continue;
+		}
+
+		if (table == NULL) {
+			bench_mismatch(va, "unmapped, expected mapped");
+			continue;
+		}
+
+		mm = &regions[id].mm;
+		desc = table[idx];
+
+		pa = (desc & TABLE_ADDR_MASK) + (va & XLAT_BLOCK_MASK(level));
+		if (pa != mm->base_pa + (va - mm->base_va))
+			bench_mismatch(va, "wrong PA");
+
+		if ((get_mem_attributes(&bench_xlat_ctx, va, &attr) != 0) ||
+		    (attr != model_attr[va / PAGE_SIZE]))
+			bench_mismatch(va, "wrong attributes");
+
+		if ((desc & UPPER_ATTRS(CONT_HINT)) != 0) {
+			if ((mm->attr & MT_NO_CONTIG_HINT) != 0)
+				bench_mismatch(va, "unexpected contiguous hint");
+			else
+				bench_check_contig(va, table, idx, level);
+		}
+	}
+}
+
+/* Returns the number of translation tables referenced from 'table' */
+static unsigned int bench_count_tables(const uint64_t *table,
+				       unsigned int entries, unsigned int level)
+{
+	unsigned int count = 0;
+
+	if (level == XLAT_TABLE_LEVEL_MAX)
+		return 0;
+
+	for (unsigned int i = 0; i < entries; i++) {
+		if ((table[i] & DESC_MASK) != TABLE_DESC)
+			continue;
+
+		count += 1 + bench_count_tables(
+			(const uint64_t *)(uintptr_t)(table[i] & TABLE_ADDR_MASK),
+			XLAT_TABLE_ENTRIES, level + 1);
+	}
+
+	return count;
+}
+
+/*
+ * Checks that the translation tables that aren't referenced by the tables of
+ * the context are free, and that dynamic regions can use them.
+ */
+static void bench_check_free_tables(void)
+{
+	unsigned int used = bench_count_tables(bench_xlat_ctx.base_table,
+					       bench_xlat_ctx.base_table_entries,
+					       bench_xlat_ctx.base_level);
+
+	if (used + bench_xlat_ctx.tables_free_num != bench_xlat_ctx.tables_num)
+		bench_mismatch(0, "translation tables leaked");
+}
+
+/*
+ * Compares the pages around an operation on [base_va, end_va] to the reference
+ * model, including those of the contiguous groups of level 2 blocks that may
+ * contain the range.
+ */
+static void bench_check_op(uintptr_t base_va, uintptr_t end_va)
+{
+	uintptr_t check_end = round_up(end_va + 1, XLAT_CONT_SIZE(2)) - 1;
+
+	bench_check_range(round_down(base_va, XLAT_CONT_SIZE(2)),
+			  MIN(check_end, (uintptr_t)(VA_SPACE_END - 1)));
+}
+
+/*******************************************************************************
+ * Benchmarked operations.
+ ******************************************************************************/
+
+static void bench_op_start(void)
+{
+	tlbi_va_count = 0;
+	tlbi_all_count = 0;
+	op_start_ns = bench_time_ns();
+}
+
+static void bench_op_end(bench_stats_t *stats, int failed)
+{
+	unsigned long long ns = bench_time_ns() - op_start_ns;
+
+	stats->calls++;
+	stats->failed += failed ? 1 : 0;
+	stats->total_ns += ns;
+	stats->max_ns = MAX(stats->max_ns, ns);
+	stats->tlbi_va += tlbi_va_count;
+	stats->tlbi_all += tlbi_all_count;
+}
+
+/* Returns the index of a free entry of the regions array, 0 if none */
+static unsigned int bench_free_region(void)
+{
+	for (unsigned int id = 1; id <= MAX_REGIONS; id++) {
+		if (!regions[id].mapped)
+			return id;
+	}
+
+	return 0;
+}
+
+/* Returns a random mapped region, dynamic only if 'dynamic' is set */
+static unsigned int bench_random_mapped_region(int dynamic)
+{
+	unsigned int ids[MAX_REGIONS];
+	unsigned int num = 0;
+
+	for (unsigned int id = 1; id <= MAX_REGIONS; id++) {
+		if (regions[id].mapped && (!dynamic || regions[id].dynamic))
+			ids[num++] = id;
+	}
+
+	return (num == 0) ? 0 : ids[rand_below(num)];
+}
+
+static void bench_add_dynamic(int check)
+{
+	unsigned int id = bench_free_region();
+	mmap_region_t mm;
+	int rc;
+
+	if (id == 0)
+		return;
+
+	bench_random_region(&mm, id, DYNAMIC_VA_BASE +
+		(uintptr_t)rand_below((VA_SPACE_END - DYNAMIC_VA_BASE) /
+				      PAGE_SIZE) * PAGE_SIZE);
+
+	if (mm.base_va + mm.size > VA_SPACE_END)
+		return;
+
+	/* Dynamic regions can't overlap, the library would reject them */
+	for (unsigned int i = 1; i <= MAX_REGIONS; i++) {
+		if (regions[i].mapped &&
+		    (mm.base_va < regions[i].mm.base_va + regions[i].mm.size) &&
+		    (regions[i].mm.base_va < mm.base_va + mm.size))
+			return;
+	}
+
+	/* The library marks its argument as dynamic */
+	regions[id].mm = mm;
+
+	bench_op_start();
+	rc = mmap_add_dynamic_region_ctx(&bench_xlat_ctx, &mm);
+	bench_op_end(&stats_add, rc != 0);
+
+	if (rc == 0) {
+		regions[id].mapped = 1;
+		regions[id].dynamic = 1;
+		bench_model_set(id);
+	} else if (rc != -ENOMEM) {
+		bench_mismatch(mm.base_va, "failed to add dynamic region");
+	}
+
+	if (check)
+		bench_check_op(mm.base_va, mm.base_va + mm.size - 1);
+}
+
+static void bench_remove_dynamic(unsigned int id, int check)
+{
+	const mmap_region_t *mm = &regions[id].mm;
+	int rc;
+
+	bench_op_start();
+	rc = mmap_remove_dynamic_region_ctx(&bench_xlat_ctx, mm->base_va,
+					    mm->size);
+	bench_op_end(&stats_remove, rc != 0);
+
+	if (rc != 0) {
+		bench_mismatch(mm->base_va, "failed to remove dynamic region");
+		return;
+	}
+
+	regions[id].mapped = 0;
+	bench_model_clear(id);
+
+	if (check)
+		bench_check_op(mm->base_va, mm->base_va + mm->size - 1);
+}
+
+/*
+ * Returns the result expected from change_mem_attributes() for the range
+ * [base_va, end_va] and 'attr', according to the reference model. 0 means that
+ * the call may succeed or fail with -ENOMEM.
+ */
+static int bench_change_expected(uintptr_t base_va, uintptr_t end_va,
+				 mmap_attr_t attr)
+{
+	if (((attr & MT_RW) != 0) && ((attr & MT_EXECUTE_NEVER) == 0))
+		return -EINVAL;
+
+	for (uintptr_t va = base_va; va <= end_va; va += PAGE_SIZE) {
+		if (model_region[va / PAGE_SIZE] == 0)
+			return -EINVAL;
+
+		if ((MT_TYPE(model_attr[va / PAGE_SIZE]) == MT_DEVICE) &&
+		    ((attr & MT_EXECUTE_NEVER) == 0))
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void bench_change_attr(int check)
+{
+	unsigned int id = bench_random_mapped_region(0);
+	const mmap_region_t *mm = &regions[id].mm;
+	size_t pages, max_pages;
+	uintptr_t base_va, end_va;
+	mmap_attr_t attr;
+	int rc, expected;
+
+	if (id == 0)
+		return;
+
+	/* Mostly small ranges inside the region, sometimes beyond its end */
+	base_va = mm->base_va + rand_below(mm->size / PAGE_SIZE) * PAGE_SIZE;
+	max_pages = (mm->base_va + mm->size - base_va) / PAGE_SIZE;
+
+	switch (rand_below(16)) {
+	case 0:
+		pages = max_pages + rand_below(64);
+		break;
+	case 1:
+		pages = max_pages;
+		break;
+	default:
+		pages = 1 + rand_below((rand_below(4) == 0) ? 1024 : 16);
+		break;
+	}
+	pages = MIN(pages, (size_t)((VA_SPACE_END - base_va) / PAGE_SIZE));
+	end_va = base_va + pages * PAGE_SIZE - 1;
+
+	attr = (rand_below(2) != 0) ? MT_RW : MT_RO;
+	attr |= (rand_below(2) != 0) ? MT_EXECUTE_NEVER : MT_EXECUTE;
+	/* Writable and executable is rejected, only try it sometimes */
+	if (((attr & MT_RW) != 0) && (rand_below(32) != 0))
+		attr |= MT_EXECUTE_NEVER;
+
+	expected = bench_change_expected(base_va, end_va, attr);
+
+	bench_op_start();
+	rc = change_mem_attributes(&bench_xlat_ctx, base_va, pages * PAGE_SIZE,
+				   attr);
+	bench_op_end(&stats_change, rc != 0);
+
+	if ((expected != 0) ? (rc != expected) :
+			      ((rc != 0) && (rc != -ENOMEM))) {
+		bench_mismatch(base_va, "unexpected change_mem_attributes() result");
+	} else if (rc == 0) {
+		for (uintptr_t va = base_va; va <= end_va; va += PAGE_SIZE) {
+			mmap_attr_t page_attr = model_attr[va / PAGE_SIZE];
+
+			page_attr &= ~(MT_RW | MT_EXECUTE_NEVER);
+			page_attr |= attr & (MT_RW | MT_EXECUTE_NEVER);
+			model_attr[va / PAGE_SIZE] = page_attr;
+		}
+	}
+
+	if (check)
+		bench_check_op(base_va, end_va);
+}
+
+/*******************************************************************************
+ * Runs.
+ ******************************************************************************/
+
+static void bench_map_static(void)
+{
+	uintptr_t va = rand_below(16) * PAGE_SIZE;
+	unsigned int num = 1 + rand_below(MAX_STATIC_REGIONS);
+	mmap_region_t *mm;
+
+	for (unsigned int id = 1; id <= num; id++) {
+		mm = &regions[id].mm;
+		bench_random_region(mm, id, va);
+
+		if (mm->base_va + mm->size > STATIC_VA_END)
+			break;
+
+		mmap_add_region_ctx(&bench_xlat_ctx, mm);
+		regions[id].mapped = 1;
+		bench_model_set(id);
+
+		va = mm->base_va + mm->size;
+		if (rand_below(2) != 0)
+			va += rand_below(512) * PAGE_SIZE;
+	}
+
+	init_xlat_tables_ctx(&bench_xlat_ctx);
+	mmu_enabled = 1;
+}
+
+static void bench_one_run(const bench_config_t *config)
+{
+	unsigned int id;
+
+	/* Start from an empty context */
+	bench_xlat_ctx = bench_ctx_reset;
+	memset(bench_xlat_ctx.mmap, 0,
+	       (bench_xlat_ctx.mmap_num + 1) * sizeof(mmap_region_t));
+	memset(regions, 0, sizeof(regions));
+	memset(model_region, 0, sizeof(model_region));
+	mmu_enabled = 0;
+
+	bench_map_static();
+	bench_check_range(0, VA_SPACE_END - 1);
+
+	for (unsigned int op = 0; op < config->ops; op++) {
+		switch (rand_below(4)) {
+		case 0:
+			bench_add_dynamic(config->check);
+			break;
+		case 1:
+			id = bench_random_mapped_region(1);
+			if (id != 0)
+				bench_remove_dynamic(id, config->check);
+			break;
+		default:
+			bench_change_attr(config->check);
+			break;
+		}
+	}
+
+	bench_check_range(0, VA_SPACE_END - 1);
+
+	bench_check_free_tables();
+
+	while ((id = bench_random_mapped_region(1)) != 0)
+		bench_remove_dynamic(id, 0);
+
+	bench_check_range(0, VA_SPACE_END - 1);
+	bench_check_free_tables();
+}
+
+static void bench_out_stats(const bench_stats_t *stats)
+{
+	unsigned long long calls = MAX(stats->calls, 1ULL);
+
+	bench_out("%-32s %8llu %8llu %10llu %10llu %10llu %10llu\n",
+		  stats->name, stats->calls, stats->failed,
+		  stats->total_ns / calls, stats->max_ns,
+		  stats->tlbi_va / calls, stats->tlbi_all);
+}
+
+unsigned int bench_run(const bench_config_t *config)
+{
+	rand_state = (config->seed != 0) ? config->seed : 1;
+	bench_ctx_reset = bench_xlat_ctx;
+
+	for (unsigned int run = 0; run < config->runs; run++)
+		bench_one_run(config);
+
+	bench_out("%-32s %8s %8s %10s %10s %10s %10s\n", "Operation", "Calls",
+		  "Failed", "Avg (ns)", "Max (ns)", "Avg TLBI", "TLBI all");
+	bench_out_stats(&stats_add);
+	bench_out_stats(&stats_remove);
+	bench_out_stats(&stats_change);
+
+	return mismatches;
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __ARCH_HELPERS_H__
+#define __ARCH_HELPERS_H__
+
+#include <sys/types.h>
+
+/*
+ * Replacement of the architectural helpers used by the xlat_tables_v2 library
+ * when it is built for the host by xlat_tables_gen. The translation tables
+ * that it generates aren't in use, so no barrier is needed.
+ */
+
+static inline void dsbish(void)
+{
+}
+
+static inline void dsbishst(void)
+{
+}
+
+static inline void isb(void)
+{
+}
+
+/* Only referenced by the inline helpers of cpu_data.h, included by platforms */
+static inline u_register_t read_tpidr_el3(void)
+{
+	return 0;
+}
+
+#endif /* __ARCH_HELPERS_H__ */
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "xlat_tables_gen.h"
+
+/*
+ * This tool generates the translation tables of BL31 at build time, for
+ * platforms built with PREGENERATE_XLAT_TABLES=1. It maps the regions of the
+ * BL31 image and the memory regions returned by the platform from
+ * plat_xlat_tables_gen_get_mmap() with the xlat_tables_v2 library, built for
+ * the host with the configuration of the platform, and outputs the resulting
+ * translation context as a C source file that is linked into BL31.
+ */
+
+/* Log level of the library messages that are output, see debug.h */
+#define LOG_LEVEL_WARNING	30
+#define LOG_LEVEL_VERBOSE	50
+
+static const char *out_filename;
+static FILE *out;
+static unsigned int max_log_level = LOG_LEVEL_WARNING;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: xlat_tables_gen [-v] -o <output file>\n\n"
+		"  -o  C source file to generate\n"
+		"  -v  Output all the messages of the library, including the\n"
+		"      memory map and the translation tables\n");
+	exit(1);
+}
+
+void xlat_gen_out(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(out, fmt, args);
+	va_end(args);
+}
+
+void xlat_gen_vlog(unsigned int level, const char *fmt, va_list args)
+{
+	if (level <= max_log_level)
+		vfprintf(stderr, fmt, args);
+}
+
+void xlat_gen_fail(void)
+{
+	/* Don't leave an incomplete file behind for the build system */
+	if (out != NULL) {
+		fclose(out);
+		remove(out_filename);
+	}
+
+	fprintf(stderr, "ERROR: Failed to generate the translation tables\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	int c;
+
+	while ((c = getopt(argc, argv, "o:vh")) != -1) {
+		switch (c) {
+		case 'o':
+			out_filename = optarg;
+			break;
+		case 'v':
+			max_log_level = LOG_LEVEL_VERBOSE;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if ((out_filename == NULL) || (optind != argc))
+		usage();
+
+	out = fopen(out_filename, "w");
+	if (out == NULL) {
+		fprintf(stderr, "ERROR: Cannot open %s: %s\n", out_filename,
+			strerror(errno));
+		exit(1);
+	}
+
+	if (xlat_gen_run() != 0)
+		xlat_gen_fail();
+
+	if (fclose(out) != 0) {
+		fprintf(stderr, "ERROR: Cannot write %s: %s\n", out_filename,
+			strerror(errno));
+		remove(out_filename);
+		exit(1);
+	}
+
+	return 0;
+}
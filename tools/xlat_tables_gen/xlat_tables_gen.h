@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __XLAT_TABLES_GEN_H__
+#define __XLAT_TABLES_GEN_H__
+
+#include <stdarg.h>
+
+/*
+ * The translation tables are built by the library code compiled against the
+ * firmware headers, in xlat_tables_gen_ctx.c, so that it uses the types and
+ * the configuration of the platform. The rest of the tool is compiled against
+ * the host headers, in xlat_tables_gen.c. This interface only uses types that
+ * are common to both.
+ */
+
+/*
+ * Build the translation tables from the memory map of the platform and emit
+ * them with xlat_gen_out(). Returns 0 on success.
+ */
+int xlat_gen_run(void);
+
+/* Output to the generated source file */
+void xlat_gen_out(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/* Output of the log messages of the library, 'level' is a LOG_LEVEL_* value */
+void xlat_gen_vlog(unsigned int level, const char *fmt, va_list args);
+
+/* Abort the generation */
+void xlat_gen_fail(void) __attribute__((noreturn));
+
+#endif /* __XLAT_TABLES_GEN_H__ */
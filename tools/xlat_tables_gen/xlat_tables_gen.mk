@@ -0,0 +1,58 @@
+#
+# Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+# Rules to build the xlat_tables_gen tool for the platform and to generate the
+# translation tables of BL31 with it. This makefile is included by bl31.mk
+# when PREGENERATE_XLAT_TABLES=1.
+
+XLATGENPATH		:=	tools/xlat_tables_gen
+XLATGEN_DIR		:=	${BUILD_PLAT}/xlat_tables_gen
+XLATGEN			:=	${XLATGEN_DIR}/xlat_tables_gen${BIN_EXT}
+XLATGEN_OUT		:=	${BUILD_PLAT}/bl31/xlat_tables_pregen.c
+
+# Sources built against the firmware headers, with the configuration of BL31
+XLATGEN_FW_SOURCES	:=	${XLATGENPATH}/xlat_tables_gen_ctx.c		\
+				lib/xlat_tables_v2/xlat_tables_internal.c	\
+				${PLAT_XLAT_TABLES_GEN_SOURCES}
+
+XLATGEN_OBJS		:=	${XLATGEN_DIR}/xlat_tables_gen.o		\
+				$(addprefix ${XLATGEN_DIR}/,			\
+					$(notdir $(XLATGEN_FW_SOURCES:.c=.o)))
+
+# The build options are only known once all the makefiles have been read, so
+# the flags are expanded when the rules are run. XLAT_TABLES_GEN makes the
+# library build the tables in the default translation context instead of using
+# the ones it generates, and the log messages of the library are output as text.
+XLATGEN_FW_CFLAGS	=	-nostdinc -ffreestanding -fno-builtin -std=gnu99 \
+				-Wall -O2 -I${XLATGENPATH}/include		\
+				-Ilib/xlat_tables_v2 ${DEFINES} ${INCLUDES}	\
+				-DIMAGE_BL31 -DXLAT_TABLES_GEN			\
+				-UENABLE_BINARY_LOG
+
+define MAKE_XLATGEN_FW_OBJ
+${XLATGEN_DIR}/$(notdir $(1:.c=.o)): $(1) | ${XLATGEN_DIR}
+	@echo "  HOSTCC  $$<"
+	$$(Q)$$(HOSTCC) $$(XLATGEN_FW_CFLAGS) -MMD -MP -c $$< -o $$@
+endef
+
+$(foreach src,${XLATGEN_FW_SOURCES},$(eval $(call MAKE_XLATGEN_FW_OBJ,${src})))
+
+${XLATGEN_DIR}/xlat_tables_gen.o: ${XLATGENPATH}/xlat_tables_gen.c | ${XLATGEN_DIR}
+	@echo "  HOSTCC  $<"
+	${Q}${HOSTCC} -Wall -O2 -MMD -MP -c $< -o $@
+
+${XLATGEN}: ${XLATGEN_OBJS}
+	@echo "  HOSTLD  $@"
+	${Q}${HOSTCC} ${XLATGEN_OBJS} -o $@
+
+${XLATGEN_OUT}: ${XLATGEN} | bl31_dirs
+	@echo "  XLATGEN $@"
+	${Q}${XLATGEN} -o $@
+
+${XLATGEN_DIR}:
+	${Q}mkdir -p $@
+
+-include $(XLATGEN_OBJS:.o=.d)
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <platform_def.h>
+#include <stdarg.h>
+#include <xlat_tables_defs.h>
+#include <xlat_tables_v2.h>
+
+#include "xlat_tables_gen.h"
+#include "xlat_tables_private.h"
+
+/*
+ * The end of the code and of the read-only data of BL31 must be fixed by the
+ * platform for the tables to be generated before BL31 is linked. bl31.ld.S
+ * checks that BL31 fits.
+ */
+#if !SEPARATE_CODE_AND_RODATA || !defined(BL31_TEXT_LIMIT) || \
+	!defined(BL31_RODATA_LIMIT)
+#error "PREGENERATE_XLAT_TABLES requires BL31_TEXT_LIMIT and BL31_RODATA_LIMIT"
+#endif
+
+/*
+ * Regions of the BL31 image, see bl31.ld.S. The whole memory of BL31 is mapped
+ * as RW data, then the code and the read-only data are re-mapped over it.
+ */
+static const mmap_region_t gen_bl31_mmap[] = {
+	MAP_REGION_FLAT(BL31_BASE, BL31_LIMIT - BL31_BASE,
+			MT_MEMORY | MT_RW | MT_SECURE),
+	MAP_REGION_FLAT(BL31_BASE, BL31_TEXT_LIMIT - BL31_BASE,
+			MT_CODE | MT_SECURE),
+	MAP_REGION_FLAT(BL31_TEXT_LIMIT, BL31_RODATA_LIMIT - BL31_TEXT_LIMIT,
+			MT_RO_DATA | MT_SECURE),
+	{0}
+};
+
+/*
+ * Returns the platform-specific memory regions of BL31, terminated by an entry
+ * of size 0. It is provided by the platform, in a source file listed in
+ * PLAT_XLAT_TABLES_GEN_SOURCES.
+ */
+const mmap_region_t *plat_xlat_tables_gen_get_mmap(void);
+
+/*
+ * Translation context with the same dimensions as the default context of BL31,
+ * see xlat_tables_internal.c.
+ */
+REGISTER_XLAT_CONTEXT(gen, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
+		PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
+
+/* Lookup level of each translation table of the context, 0 if unused */
+static unsigned int gen_tables_level[MAX_XLAT_TABLES];
+
+/*******************************************************************************
+ * Host implementations of the firmware services used by the library.
+ ******************************************************************************/
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	xlat_gen_vlog(LOG_LEVEL_VERBOSE, fmt, args);
+	va_end(args);
+}
+
+void tf_log(const char *fmt, ...)
+{
+	va_list args;
+
+	/* The first character of the format string is the log level */
+	va_start(args, fmt);
+	xlat_gen_vlog(fmt[0], fmt + 1, args);
+	va_end(args);
+}
+
+#if PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_VERBOSE
+void __assert(const char *file, unsigned int line, const char *assertion)
+{
+	tf_log(LOG_MARKER_ERROR "ASSERT: %s:%d:%s\n", file, line, assertion);
+	xlat_gen_fail();
+}
+#elif PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_INFO
+void __assert(const char *file, unsigned int line)
+{
+	tf_log(LOG_MARKER_ERROR "ASSERT: %s:%d\n", file, line);
+	xlat_gen_fail();
+}
+#else
+void __assert(void)
+{
+	xlat_gen_fail();
+}
+#endif
+
+void do_panic(void)
+{
+	xlat_gen_fail();
+}
+
+/*
+ * The architectural operations aren't needed to build translation tables that
+ * are not in use. The maximum PA supported by the CPU isn't known at build
+ * time, so it is checked by BL31 when it initialises the translation tables.
+ */
+unsigned long long xlat_arch_get_max_supported_pa(void)
+{
+	return ~0ULL;
+}
+
+int is_mmu_enabled_ctx(const xlat_ctx_t *ctx __unused)
+{
+	return 0;
+}
+
+void xlat_arch_tlbi_va(uintptr_t va __unused)
+{
+}
+
+void xlat_arch_tlbi_va_regime(uintptr_t va __unused,
+			      xlat_regime_t xlat_regime __unused)
+{
+}
+
+void xlat_arch_tlbi_all_regime(xlat_regime_t xlat_regime __unused)
+{
+}
+
+void xlat_arch_tlbi_va_sync(void)
+{
+}
+
+void enable_mmu_arch(unsigned int flags __unused,
+		     uint64_t *base_table __unused,
+		     unsigned long long max_pa __unused,
+		     uintptr_t max_va __unused)
+{
+	xlat_gen_fail();
+}
+
+/*******************************************************************************
+ * Generation of the translation context.
+ ******************************************************************************/
+
+/* Returns the index in the context of the table referenced by 'desc' */
+static unsigned int gen_table_index(uint64_t desc)
+{
+	uintptr_t offset = (uintptr_t)(desc & TABLE_ADDR_MASK) -
+			   (uintptr_t)gen_xlat_ctx.tables;
+
+	assert((offset / sizeof(*gen_xlat_ctx.tables)) <
+	       gen_xlat_ctx.tables_num);
+
+	return offset / sizeof(*gen_xlat_ctx.tables);
+}
+
+/* Records the lookup level of the tables referenced by the given table */
+static void gen_find_tables_level(const uint64_t *table,
+				  unsigned int table_entries,
+				  unsigned int level)
+{
+	unsigned int idx;
+
+	if (level == XLAT_TABLE_LEVEL_MAX)
+		return;
+
+	for (unsigned int i = 0; i < table_entries; i++) {
+		if ((table[i] & DESC_MASK) != TABLE_DESC)
+			continue;
+
+		idx = gen_table_index(table[i]);
+		gen_tables_level[idx] = level + 1;
+		gen_find_tables_level(gen_xlat_ctx.tables[idx],
+				      XLAT_TABLE_ENTRIES, level + 1);
+	}
+}
+
+/*
+ * Outputs the valid entries of a table. The table descriptors reference the
+ * tables by symbol, so their addresses are resolved when BL31 is linked.
+ */
+static void gen_out_table(const char *indent, const uint64_t *table,
+			  unsigned int table_entries, unsigned int level)
+{
+	for (unsigned int i = 0; i < table_entries; i++) {
+		if ((table[i] & DESC_MASK) == INVALID_DESC)
+			continue;
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((table[i] & DESC_MASK) == TABLE_DESC)) {
+			xlat_gen_out("%s[%u] = (uintptr_t)tf_xlat_tables[%u] + TABLE_DESC,\n",
+				     indent, i, gen_table_index(table[i]));
+		} else {
+			xlat_gen_out("%s[%u] = 0x%016llxULL,\n", indent, i,
+				     (unsigned long long)table[i]);
+		}
+	}
+}
+
+static void gen_out_mmap(void)
+{
+	const mmap_region_t *mm;
+
+	xlat_gen_out("static mmap_region_t tf_mmap[%u] = {\n",
+		     gen_xlat_ctx.mmap_num + 1);
+
+	for (mm = gen_xlat_ctx.mmap; mm->size != 0; mm++) {
+		xlat_gen_out("\t{\n"
+			     "\t\t.base_pa = 0x%llxULL,\n"
+			     "\t\t.base_va = 0x%llxUL,\n"
+			     "\t\t.size = 0x%llxUL,\n"
+			     "\t\t.attr = 0x%x,\n"
+			     "\t\t.granularity = 0x%llxUL,\n"
+			     "\t},\n",
+			     mm->base_pa, (unsigned long long)mm->base_va,
+			     (unsigned long long)mm->size, (unsigned int)mm->attr,
+			     (unsigned long long)mm->granularity);
+	}
+
+	xlat_gen_out("};\n\n");
+}
+
+static void gen_out_tables(void)
+{
+	unsigned int i;
+
+	xlat_gen_out("static uint64_t tf_xlat_tables[%u][XLAT_TABLE_ENTRIES]\n"
+		     "\t__aligned(XLAT_TABLE_SIZE) = {\n",
+		     gen_xlat_ctx.tables_num);
+
+	for (i = 0; i < gen_xlat_ctx.tables_num; i++) {
+		if (gen_tables_level[i] == 0)
+			continue;
+
+		xlat_gen_out("\t[%u] = {\t/* Level %u */\n", i,
+			     gen_tables_level[i]);
+		gen_out_table("\t\t", gen_xlat_ctx.tables[i],
+			      XLAT_TABLE_ENTRIES, gen_tables_level[i]);
+		xlat_gen_out("\t},\n");
+	}
+
+	xlat_gen_out("};\n\n");
+
+	xlat_gen_out("static uint64_t tf_base_xlat_table[%u]\n"
+		     "\t__aligned(%u * sizeof(uint64_t)) = {\n",
+		     gen_xlat_ctx.base_table_entries,
+		     gen_xlat_ctx.base_table_entries);
+	gen_out_table("\t", gen_xlat_ctx.base_table,
+		      gen_xlat_ctx.base_table_entries, gen_xlat_ctx.base_level);
+	xlat_gen_out("};\n\n");
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	xlat_gen_out("static int tf_mapped_regions[%u] = {\n",
+		     gen_xlat_ctx.tables_num);
+	for (i = 0; i < gen_xlat_ctx.tables_num; i++)
+		xlat_gen_out("\t%d,\n", gen_xlat_ctx.tables_mapped_regions[i]);
+	xlat_gen_out("};\n\n");
+
+	xlat_gen_out("static unsigned int tf_free_tables[%u] = {\n",
+		     gen_xlat_ctx.tables_num);
+	for (i = 0; i < gen_xlat_ctx.tables_free_num; i++)
+		xlat_gen_out("\t%u,\n", gen_xlat_ctx.tables_free[i]);
+	xlat_gen_out("};\n\n");
+#endif
+}
+
+static void gen_out_ctx(void)
+{
+	xlat_gen_out("xlat_ctx_t tf_xlat_ctx = {\n"
+		     "\t.pa_max_address = 0x%llxULL,\n"
+		     "\t.va_max_address = 0x%llxUL,\n"
+		     "\t.mmap = tf_mmap,\n"
+		     "\t.mmap_num = %u,\n"
+		     "\t.tables = tf_xlat_tables,\n"
+		     "\t.tables_num = %u,\n",
+		     gen_xlat_ctx.pa_max_address,
+		     (unsigned long long)gen_xlat_ctx.va_max_address,
+		     gen_xlat_ctx.mmap_num, gen_xlat_ctx.tables_num);
+#if PLAT_XLAT_TABLES_DYNAMIC
+	xlat_gen_out("\t.tables_mapped_regions = tf_mapped_regions,\n"
+		     "\t.tables_free = tf_free_tables,\n"
+		     "\t.tables_free_num = %u,\n",
+		     gen_xlat_ctx.tables_free_num);
+#endif
+	xlat_gen_out("\t.next_table = %u,\n"
+		     "\t.base_table = tf_base_xlat_table,\n"
+		     "\t.base_table_entries = %u,\n"
+		     "\t.max_pa = 0x%llxULL,\n"
+		     "\t.max_va = 0x%llxUL,\n"
+		     "\t.base_level = %u,\n"
+		     "\t.initialized = 1,\n"
+		     "\t.xlat_regime = %d,\n"
+		     "};\n",
+		     gen_xlat_ctx.next_table, gen_xlat_ctx.base_table_entries,
+		     gen_xlat_ctx.max_pa,
+		     (unsigned long long)gen_xlat_ctx.max_va,
+		     gen_xlat_ctx.base_level, gen_xlat_ctx.xlat_regime);
+}
+
+int xlat_gen_run(void)
+{
+	const mmap_region_t *mm;
+
+	mmap_add_ctx(&gen_xlat_ctx, gen_bl31_mmap);
+	mmap_add_ctx(&gen_xlat_ctx, plat_xlat_tables_gen_get_mmap());
+	init_xlat_tables_ctx(&gen_xlat_ctx);
+
+	gen_find_tables_level(gen_xlat_ctx.base_table,
+			      gen_xlat_ctx.base_table_entries,
+			      gen_xlat_ctx.base_level);
+
+	xlat_gen_out("/*\n"
+		     " * Translation tables of BL31, generated by xlat_tables_gen. Do not edit.\n"
+		     " *\n"
+		     " * Memory map:\n");
+	for (mm = gen_xlat_ctx.mmap; mm->size != 0; mm++) {
+		xlat_gen_out(" *   VA:0x%llx PA:0x%llx size:0x%llx attr:0x%x\n",
+			     (unsigned long long)mm->base_va, mm->base_pa,
+			     (unsigned long long)mm->size,
+			     (unsigned int)mm->attr);
+	}
+	xlat_gen_out(" */\n\n"
+		     "#include <stdint.h>\n"
+		     "#include <xlat_tables_defs.h>\n"
+		     "#include <xlat_tables_v2.h>\n\n");
+
+	gen_out_mmap();
+	gen_out_tables();
+	gen_out_ctx();
+
+	return 0;
+}